@@ -1,4 +1,7 @@
 {
+  'variables': {
+    'have_sdt%': '<!(test -f /usr/include/sys/sdt.h && echo 1 || echo 0)'
+  },
   'targets': [{
     'target_name': 'pulse',
     'defines': [
@@ -6,7 +9,19 @@
     ],
     'sources': [
       'src/context.cc',
+      'src/batch.cc',
       'src/stream.cc',
+      'src/sample.cc',
+      'src/gain.cc',
+      'src/biquad.cc',
+      'src/remix.cc',
+      'src/vad.cc',
+      'src/analyser.cc',
+      'src/file-source.cc',
+      'src/recorder.cc',
+      'src/adaptive-latency.cc',
+      'src/drift.cc',
+      'src/jitter.cc',
       'src/uv-mainloop.cc',
       'src/addon.cc'
     ],
@@ -25,6 +40,13 @@
     'libraries': [
       '<!@(pkg-config  --libs libpulse)'
     ],
+    'conditions': [
+      ['have_sdt==1', {
+        'defines': [
+          'HAVE_SDT'
+        ]
+      }]
+    ],
     'include_dirs': [
       "<!(node -e \"require('nan')\")",
     ]
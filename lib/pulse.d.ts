@@ -24,7 +24,9 @@ declare class PulseAudio extends events.EventEmitter {
         client ?: string;
         server ?: string;
         flags ?: string;
-        properties ?: Record<string, string>
+        properties ?: Record<string, string>;
+        memoryBudget ?: number;
+        overBudget ?: 'drop'|'error';
     });
 
     on(ev : 'connection', cb : () => void) : this;
@@ -38,16 +40,30 @@ declare class PulseAudio extends events.EventEmitter {
     setSourceMute(sink : string|number, mute : boolean) : Promise<void>;
     setSourceVolume(sink : string|number, volume : number[]) : Promise<void>;
 
+    setSinkInputMute(index : number, mute : boolean) : Promise<void>;
+    setSinkInputVolume(index : number, volume : number[]) : Promise<void>;
+
     info() : Promise<PulseAudio.ServerInfo>;
     modules() : Promise<PulseAudio.ModuleInfo[]>;
     source() : Promise<PulseAudio.SourceOrSinkInfo[]>;
     sink() : Promise<PulseAudio.SourceOrSinkInfo[]>;
+    sinkInputs() : Promise<PulseAudio.SinkInputInfo[]>;
+
+    moveSinkInput(index : number, sink : string|number) : Promise<void>;
+    moveSourceOutput(index : number, source : string|number) : Promise<void>;
+
+    batch(steps : PulseAudio.BatchStep[], opts ?: { rollback ?: boolean }) : Promise<PulseAudio.BatchResult[]>;
 
     loadModule(name : string, args ?: string) : Promise<void>;
     unloadModule(index : number) : Promise<void>;
 
     createRecordStream(opts ?: PulseAudio.StreamOptions) : PulseAudio.RecordStream;
     createPlaybackStream(opts ?: PulseAudio.StreamOptions) : PulseAudio.PlaybackStream;
+    createPlaybackGroup(list : PulseAudio.StreamOptions[]) : PulseAudio.PlaybackGroup;
+    preparePlaybackStreams(opts : PulseAudio.StreamOptions, count : number) : void;
+
+    memoryUsage() : PulseAudio.MemoryUsage & { budget : number };
+    setMemoryBudget(budget : number, policy ?: 'drop'|'error') : this;
 
     end() : void;
 }
@@ -66,6 +82,23 @@ declare namespace PulseAudio {
         volume : number[];
     }
 
+    export interface SinkInputInfo {
+        name : string;
+        index : number;
+        client : number;
+        sink : number;
+        format : string;
+        rate : number;
+        channels : number;
+        mute : boolean;
+        corked : boolean;
+        latency : number;
+        driver : string;
+        application : string;
+        pid : number;
+        volume : number[];
+    }
+
     export interface ServerInfo {
         user_name : string;
         host_name : string;
@@ -92,18 +125,242 @@ declare namespace PulseAudio {
         properties ?: Record<string, string>;
         device ?: string;
         flags ?: string;
+        monitor ?: number;
+        channelMap ?: string;
+        formats ?: Array<string|StreamFormat>;
     }
 
-    export interface PlaybackStream extends stream.Writable {
+    export type Encoding = 'any'|'pcm'|'ac3_iec61937'|'eac3_iec61937'|'mpeg_iec61937'|'dts_iec61937'|'mpeg2_aac_iec61937';
+
+    export interface StreamFormat {
+        encoding : Encoding;
+        rate ?: number;
+        channels ?: number;
+    }
+
+    export interface FormatInfo extends StreamFormat {
+        description : string;
+    }
+
+    export interface GainOptions {
+        duration ?: number;
+        curve ?: 'linear'|'exponential';
+        delay ?: number;
+    }
+
+    export interface EqBand {
+        type ?: 'lowpass'|'highpass'|'bandpass'|'notch'|'peaking'|'lowshelf'|'highshelf';
+        frequency : number;
+        q ?: number;
+        gain ?: number;
+    }
+
+    export interface TimingInfo {
+        timestamp : number;
+        synchronized_clocks : boolean;
+        sink_usec : number;
+        source_usec : number;
+        transport_usec : number;
+        playing : boolean;
+        write_index_corrupt : boolean;
+        write_index : number;
+        read_index_corrupt : boolean;
+        read_index : number;
+        configured_sink_usec : number;
+        configured_source_usec : number;
+        since_underrun : number;
+    }
+
+    export type BatchStep =
+        { op : 'loadModule', name : string, args ?: string } |
+        { op : 'unloadModule', index : number } |
+        { op : 'setSinkVolume', sink : string|number, volume : number[] } |
+        { op : 'setSinkMute', sink : string|number, mute : boolean } |
+        { op : 'setSourceVolume', source : string|number, volume : number[] } |
+        { op : 'setSourceMute', source : string|number, mute : boolean } |
+        { op : 'setSinkInputVolume', index : number, volume : number[] } |
+        { op : 'setSinkInputMute', index : number, mute : boolean } |
+        { op : 'moveSinkInput', index : number, sink : string|number } |
+        { op : 'moveSourceOutput', index : number, source : string|number };
+
+    export interface BatchResult {
+        index ?: number;
+        error ?: string;
+        rolledBack ?: boolean;
+    }
+
+    export interface MemoryUsage {
+        native : number;
+        queued : number;
+    }
+
+    export interface DeviceInfo {
+        name : string;
+        index : number;
+    }
+
+    export interface StreamControls {
+        readonly droppedBytes : number;
+        memoryUsage() : MemoryUsage;
+
+        setGain(gain : number, opts ?: GainOptions) : this;
+        mute(opts ?: GainOptions) : this;
+        unmute(opts ?: GainOptions) : this;
+
+        index() : number|null;
+        device() : DeviceInfo|null;
+        moveTo(device : string|number) : Promise<this>;
+
+        formatInfo() : FormatInfo|null;
+        setRemix(channels : number|null, matrix ?: number[][]) : Promise<this>;
+        setEq(bands : EqBand[]) : this;
+        setEqBand(index : number, band : EqBand) : this;
+
+        latency() : number;
+        time() : number;
+        clock() : number;
+        timing() : TimingInfo|null;
+        updateTiming() : Promise<void>;
+        setRate(rate : number) : Promise<void>;
+    }
+
+    export interface PlaybackGroup extends events.EventEmitter {
+        readonly streams : PlaybackStream[];
+        readonly leader : PlaybackStream;
+        startTime : number|null;
+
+        on(ev : 'start', cb : (time : number) => void) : this;
+        on(ev : 'error', cb : (err : Error) => void) : this;
+
+        cork() : Promise<void>;
+        uncork() : Promise<void>;
+        start() : Promise<void>;
+        end() : void;
+    }
+
+    export interface AdaptiveLatencyOptions {
+        min ?: number;
+        max ?: number;
+        settle ?: number;
+    }
+
+    export interface IdleCorkOptions {
+        timeout ?: number;
+        silence ?: boolean;
+    }
+
+    export interface JitterBufferOptions {
+        min ?: number;
+        max ?: number;
+    }
+
+    export interface JitterStats {
+        depth : number;
+        target : number;
+        jitter : number;
+        received : number;
+        late : number;
+        concealed : number;
+        skipped : number;
+        refused : number;
+    }
+
+    export interface AnalyserOptions {
+        size ?: number;
+        hop ?: number;
+        rate ?: number;
+        bands ?: number;
+        decibels ?: boolean;
+    }
+
+    export interface PlayFileOptions {
+        loop ?: boolean;
+        start ?: number;
+    }
+
+    export interface PlaybackStream extends stream.Writable, StreamControls {
+        on(ev : 'started', cb : (time : number) => void) : this;
+        on(ev : 'moved', cb : (name : string, index : number) => void) : this;
+        on(ev : 'played', cb : () => void) : this;
+        on(ev : 'latency', cb : (latency : number) => void) : this;
+        on(ev : 'rate', cb : (rate : number) => void) : this;
+        on(ev : 'idle', cb : () => void) : this;
+        on(ev : 'active', cb : () => void) : this;
+        on(ev : string|symbol, cb : (...args : any[]) => void) : this;
+
+
         stop() : void;
         play() : void;
         discard() : void;
+        replace(chunk : Buffer, encoding ?: string, cb ?: (err ?: Error) => void) : boolean;
+        trigger() : Promise<void>;
+
+        adaptiveLatency(opts ?: AdaptiveLatencyOptions|null|false) : Promise<this>;
+
+        idleCork(opts ?: IdleCorkOptions|null|false) : Promise<this>;
+
+        jitterBuffer(opts ?: JitterBufferOptions|null|false) : Promise<this>;
+        pushPacket(timestamp : number, chunk : Buffer) : this;
+        jitterStats() : JitterStats|null;
+
+        playFile(path : string, opts ?: PlayFileOptions) : Promise<number>;
+        seekFile(seconds : number) : this;
+        stopFile() : this;
     }
 
-    export interface RecordStream extends stream.Readable {
+    export interface LinkOptions {
+        gain ?: number;
+        latency ?: number;
+        drift ?: boolean|number;
+    }
+
+    export interface VadOptions {
+        threshold ?: number;
+        margin ?: number;
+        zeroCrossings ?: number;
+        hangover ?: number;
+        preroll ?: number;
+    }
+
+    export interface SubscribeOptions {
+        limit ?: number;
+        policy ?: 'drop_oldest'|'drop_newest';
+        highWaterMark ?: number;
+    }
+
+    export interface Subscription extends stream.Readable {
+        readonly dropped : number;
+    }
+
+    export interface RecordFileOptions {
+        format ?: 'wav'|'raw';
+        sync ?: 'none'|'close'|'periodic';
+        buffer ?: number;
+        flush ?: number;
+    }
+
+    export interface RecordStream extends stream.Readable, StreamControls {
+        on(ev : 'speechstart'|'speechend', cb : () => void) : this;
+        on(ev : 'spectrum', cb : (spectrum : Float32Array) => void) : this;
+        on(ev : 'moved', cb : (name : string, index : number) => void) : this;
+        on(ev : 'recording', cb : (frames : number, dropped : number) => void) : this;
+        on(ev : 'recorded', cb : (frames : number, dropped : number, error ?: string) => void) : this;
+        on(ev : string|symbol, cb : (...args : any[]) => void) : this;
+
         stop() : void;
         play() : void;
         end() : void;
+
+        vad(opts ?: VadOptions|null|false) : this;
+        analyse(opts ?: AnalyserOptions|null|false) : Promise<Float32Array|null>;
+
+        link(playback : PlaybackStream, opts ?: LinkOptions) : Promise<this>;
+        unlink() : this;
+
+        subscribe(opts ?: SubscribeOptions) : Subscription;
+
+        recordFile(path : string, opts ?: RecordFileOptions) : Promise<this>;
+        stopRecording() : Promise<{ frames : number, dropped : number }|null>;
     }
 }
 
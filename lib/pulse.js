@@ -127,6 +127,12 @@ class Context extends Events.EventEmitter {
         });
 
         this._connected = false;
+        this._pools = new Map();
+        this._streams = new Set();
+        // bytes queued in the JS buffers of these streams, kept up to date
+        // by the streams rather than summed on each write
+        this._queued = 0;
+        this.setMemoryBudget(opts.memoryBudget || 0, opts.overBudget);
 
         process.nextTick(() => {
             try{
@@ -146,30 +152,44 @@ class Context extends Events.EventEmitter {
 
     async setSinkMute(sink, mute) {
         await waitConnection(this);
-        const [promise, cb] = makePromise(this);
-        this.$.set_mute(PulseContext.info.sink_list, sink, mute ? 1 : 0, cb);
-        return promise;
+        return new Promise((resolve, reject) => {
+            this.$.set_mute(PulseContext.info.sink_list, sink, mute ? 1 : 0, (err) => err ? reject(err) : resolve());
+        });
     }
 
     async setSinkVolume(sink, volume) {
         await waitConnection(this);
-        const [promise, cb] = makePromise(this);
-        this.$.set_volume(PulseContext.info.sink_list, sink, volume, cb);
-        return promise;
+        return new Promise((resolve, reject) => {
+            this.$.set_volume(PulseContext.info.sink_list, sink, volume, (err) => err ? reject(err) : resolve());
+        });
     }
 
     async setSourceMute(sink, mute) {
         await waitConnection(this);
-        const [promise, cb] = makePromise(this);
-        this.$.set_mute(PulseContext.info.source_list, sink, mute ? 1 : 0, cb);
-        return promise;
+        return new Promise((resolve, reject) => {
+            this.$.set_mute(PulseContext.info.source_list, sink, mute ? 1 : 0, (err) => err ? reject(err) : resolve());
+        });
     }
 
     async setSourceVolume(sink, volume) {
         await waitConnection(this);
-        const [promise, cb] = makePromise(this);
-        this.$.set_volume(PulseContext.info.source_list, sink, volume, cb);
-        return promise;
+        return new Promise((resolve, reject) => {
+            this.$.set_volume(PulseContext.info.source_list, sink, volume, (err) => err ? reject(err) : resolve());
+        });
+    }
+
+    async setSinkInputMute(index, mute) {
+        await waitConnection(this);
+        return new Promise((resolve, reject) => {
+            this.$.set_mute(PulseContext.info.sink_input_list, index, mute ? 1 : 0, (err) => err ? reject(err) : resolve());
+        });
+    }
+
+    async setSinkInputVolume(index, volume) {
+        await waitConnection(this);
+        return new Promise((resolve, reject) => {
+            this.$.set_volume(PulseContext.info.sink_input_list, index, volume, (err) => err ? reject(err) : resolve());
+        });
     }
 
     async info() {
@@ -200,6 +220,57 @@ class Context extends Events.EventEmitter {
         return promise;
     }
 
+    // Streams played by applications, e.g. to pick one to record with the
+    // `monitor` option of createRecordStream().
+    async sinkInputs() {
+        await waitConnection(this);
+        const [promise, cb] = infoListWrap(this);
+        this.$.info(PulseContext.info.sink_input_list, cb);
+        return promise;
+    }
+
+    // Move a stream played (or recorded) by any client to another sink (or
+    // source), given by name or index; the stream keeps playing, with what
+    // it buffered, on the new device.
+    async moveSinkInput(index, sink) {
+        await waitConnection(this);
+        return new Promise((resolve, reject) => {
+            this.$.move(PulseStream.type.playback, index, sink, (err) => err ? reject(err) : resolve());
+        });
+    }
+
+    async moveSourceOutput(index, source) {
+        await waitConnection(this);
+        return new Promise((resolve, reject) => {
+            this.$.move(PulseStream.type.record, index, source, (err) => err ? reject(err) : resolve());
+        });
+    }
+
+    // Issue a list of control operations at once, e.g. to reconfigure
+    // routing, rather than one round trip each. Steps are objects named
+    // after the methods above: { op: 'loadModule', name, args },
+    // { op: 'unloadModule', index }, { op: 'setSinkVolume', sink, volume },
+    // { op: 'setSourceMute', source, mute }, { op: 'setSinkInputVolume',
+    // index, volume }, { op: 'moveSinkInput', index, sink }... and resolve
+    // to one result per step, { index } for loaded modules. If a step fails
+    // the promise is rejected, with the results on the error; with the
+    // rollback option the steps that succeeded are undone first.
+    async batch(steps, opts) {
+        opts = opts || {};
+        await waitConnection(this);
+        const results = await new Promise((resolve) => {
+            this.$.batch(steps.map(batchStep), !!opts.rollback, resolve);
+        });
+        const failed = results.findIndex((result) => result.error);
+        if (failed >= 0) {
+            const err = new Error(`Batch step ${failed} (${steps[failed].op}) failed: ${results[failed].error}`);
+            err.step = failed;
+            err.results = results;
+            throw err;
+        }
+        return results;
+    }
+
     async loadModule(name, args) {
         await waitConnection(this);
         const [promise, cb] = makePromise(this);
@@ -214,14 +285,69 @@ class Context extends Events.EventEmitter {
         return promise;
     }
 
+    // Bytes held for the streams of this context: `native` is allocated by
+    // the addon (and reported to V8), `queued` is audio waiting in stream
+    // buffers, in JS or natively.
+    memoryUsage() {
+        const usage = this.$.memory();
+        usage.queued += this._queued;
+        return usage;
+    }
+
+    // Past `budget` bytes (0 for none), audio that would need more memory is
+    // dropped, or with the 'error' policy fails its stream.
+    setMemoryBudget(budget, policy) {
+        this._memoryBudget = budget;
+        this._overBudget = policy === 'error' ? 'error' : 'drop';
+        this.$.set_memory_budget(budget);
+        return this;
+    }
+
+    _exceedsBudget(size) {
+        if (!this._memoryBudget)
+            return false;
+        const usage = this.memoryUsage();
+        return usage.native + usage.queued + size > this._memoryBudget;
+    }
+
     createRecordStream(opts) {
         return new RecordStream(this, opts);
     }
     createPlaybackStream(opts) {
+        const pool = this._pools.get(poolKey(opts));
+        if (pool) {
+            const stream = pool.acquire();
+            if (stream)
+                return stream;
+        }
         return new PlaybackStream(this, opts);
     }
 
+    // Keep `count` playback streams with these options connected and corked,
+    // so that createPlaybackStream() with the same options returns one
+    // instantly. A count of 0 drops the pool.
+    preparePlaybackStreams(opts, count) {
+        const key = poolKey(opts);
+        let pool = this._pools.get(key);
+        if (!pool) {
+            if (!count)
+                return;
+            pool = new StreamPool(this, opts);
+            this._pools.set(key, pool);
+        }
+        pool.resize(count);
+        if (!count)
+            this._pools.delete(key);
+    }
+    createPlaybackGroup(list) {
+        return new PlaybackGroup(this, list);
+    }
+
     end() {
+        for (const pool of this._pools.values())
+            pool.resize(0);
+        this._pools.clear();
+
         this.emit('end');
         this.$.disconnect();
     }
@@ -229,16 +355,47 @@ class Context extends Events.EventEmitter {
 
 /* Streams */
 
+// Candidate formats for pa_stream_new_extended, as strings in the
+// PulseAudio syntax or { encoding, format, rate, channels }; PCM
+// candidates need all of format, rate and channels.
+function formatArg(format) {
+    if ('string' === typeof format)
+        return format;
+    return {
+        encoding: str2num(format.encoding, PulseStream.encoding, PulseStream.encoding.pcm),
+        format: str2num(format.format, PulseStream.format),
+        rate: format.rate,
+        channels: format.channels
+    };
+}
+
 function createStream(ctx, self, opts, type){
     opts = opts || {};
 
     self._connected = false;
+    self._rate = opts.rate || 44100;
+    self._ctx = ctx;
+    self._type = type;
+    self.droppedBytes = 0;
+    self._queued = 0;
+
+    ctx._streams.add(self);
+    self.once('close', () => {
+        ctx._streams.delete(self);
+        ctx._queued -= self._queued;
+        self._queued = 0;
+    });
 
     const stm = self.$ = new PulseStream(ctx.$, str2num(opts.format, PulseStream.format), opts.rate, opts.channels, opts.latency, opts.stream, opts.properties || {}, (state, error) => {
         self.emit('state', num2str(state, PulseStream.state));
         switch(state){
         case PulseStream.state.ready:
             self._connected = true;
+            if (opts.formats) {
+                const info = stm.format_info();
+                if (info && info.rate)
+                    self._rate = info.rate;
+            }
             self.emit('connection');
             break;
         case PulseStream.state.failed:
@@ -249,6 +406,11 @@ function createStream(ctx, self, opts, type){
             self.emit('close');
             break;
         }
+    }, opts.channelMap, opts.formats ? opts.formats.map(formatArg) : undefined);
+
+    // events raised by the native stream, e.g. speechstart
+    stm.events((name, ...args) => {
+        self.emit(name, ...args);
     });
 
     self.on(({
@@ -259,7 +421,9 @@ function createStream(ctx, self, opts, type){
     });
 
     ctx._connection(() => {
-        stm.connect(opts.device, PulseStream.type[type], str2bit(opts.flags, PulseStream.flags));
+        if (type === 'record' && typeof opts.monitor === 'number')
+            stm.monitor(opts.monitor);
+        stm.connect(opts.device, PulseStream.type[type], str2bit(opts.flags, PulseStream.flags), opts.sync ? opts.sync.$ : null);
     });
 
     self.play();
@@ -267,6 +431,193 @@ function createStream(ctx, self, opts, type){
     return stm;
 }
 
+/* Context batches, steps in the form expected by the native layer */
+
+function batchStep(step) {
+    const info = PulseContext.info;
+    const op = PulseContext.batch;
+    switch (step.op) {
+    case 'loadModule':
+        return [op.load_module, 0, step.name, step.args || ""];
+    case 'unloadModule':
+        return [op.unload_module, 0, step.index, null];
+    case 'setSinkVolume':
+        return [op.set_volume, info.sink_list, step.sink, step.volume];
+    case 'setSinkMute':
+        return [op.set_mute, info.sink_list, step.sink, step.mute ? 1 : 0];
+    case 'setSourceVolume':
+        return [op.set_volume, info.source_list, step.source, step.volume];
+    case 'setSourceMute':
+        return [op.set_mute, info.source_list, step.source, step.mute ? 1 : 0];
+    case 'setSinkInputVolume':
+        return [op.set_volume, info.sink_input_list, step.index, step.volume];
+    case 'setSinkInputMute':
+        return [op.set_mute, info.sink_input_list, step.index, step.mute ? 1 : 0];
+    case 'moveSinkInput':
+        return [op.move_sink_input, 0, step.index, step.sink];
+    case 'moveSourceOutput':
+        return [op.move_source_output, 0, step.index, step.source];
+    default:
+        throw new TypeError(`Invalid batch operation ${step.op}`);
+    }
+}
+
+/* Methods shared by record and playback streams */
+
+const streamMethods = {
+    // Schedule a gain change, sample-accurately, on the frames written to (or
+    // read from) the stream. Duration and delay are in frames, counted from
+    // the next frame processed.
+    setGain(gain, opts) {
+        opts = opts || {};
+        this.$.gain(gain, opts.duration || 0, str2num(opts.curve, PulseStream.curve, PulseStream.curve.linear), opts.delay || 0);
+        return this;
+    },
+
+    mute(opts) {
+        return this.setGain(0, opts);
+    },
+
+    unmute(opts) {
+        return this.setGain(1, opts);
+    },
+
+    // Filter the frames written to (or read from) the stream through a chain
+    // of biquad sections, run natively before the gain. Each band is
+    // { type, frequency, q, gain }, with the frequency in Hz and the gain (for
+    // peaking and shelf filters) in dB. Bands can be updated while playing;
+    // an empty list removes the filters.
+    setEq(bands) {
+        bands = bands || [];
+        this.$.eq_truncate(bands.length);
+        bands.forEach((band, i) => this.setEqBand(i, band));
+        return this;
+    },
+
+    setEqBand(index, band) {
+        this.$.eq(index, str2num(band.type, PulseStream.filter, PulseStream.filter.peaking),
+                  band.frequency, band.q || Math.SQRT1_2, band.gain || 0);
+        return this;
+    },
+
+    // Timing, in microseconds. latency() and time() are computed by
+    // libpulse from the last timing update (interpolated with the
+    // interpolate_timing flag); clock() extrapolates the stream time from
+    // the last update with the local monotonic clock and never goes back,
+    // but after what flushes the stream (discard(), replace(), seekFile()...);
+    // without the auto_timing_update flag, it requests an update for the
+    // next calls.
+    latency() {
+        return this.$.latency();
+    },
+
+    time() {
+        return this.$.time();
+    },
+
+    clock() {
+        return this.$.clock();
+    },
+
+    timing() {
+        return this.$.timing();
+    },
+
+    async updateTiming() {
+        await waitConnection(this);
+        const [promise, cb] = makePromise(this);
+        this.$.update_timing(cb);
+        return promise;
+    },
+
+    // Mix natively between `channels` channels and those of the stream,
+    // with one row of gains per output channel: what is written to playback
+    // streams is mixed into the stream channels, record streams deliver
+    // their channels mixed down (or up) to `channels`. null removes it.
+    async setRemix(channels, matrix) {
+        await waitConnection(this);
+        if (channels === null) {
+            this.$.remix(null);
+            return this;
+        }
+        this.$.remix(channels, [].concat(...matrix));
+        return this;
+    },
+
+    // The format negotiated with the server, for streams created with a
+    // list of `formats`; null until the stream is connected.
+    formatInfo() {
+        const info = this.$.format_info();
+        if (info)
+            info.encoding = num2str(info.encoding, PulseStream.encoding);
+        return info;
+    },
+
+    // The sink input (or source output) index of the stream, and the device
+    // it plays on (or records from); null until the stream is connected.
+    // The stream emits 'moved' when it changes device, whoever moved it.
+    index() {
+        return this.$.index();
+    },
+
+    device() {
+        return this.$.device();
+    },
+
+    // Switch to another sink (or source) without recreating the stream.
+    async moveTo(device) {
+        await waitConnection(this);
+        if (this._type === 'playback')
+            await this._ctx.moveSinkInput(this.index(), device);
+        else
+            await this._ctx.moveSourceOutput(this.index(), device);
+        return this;
+    },
+
+    // Bytes held for this stream, as in Context.memoryUsage().
+    memoryUsage() {
+        const usage = this.$.memory();
+        usage.queued += this._queuedBytes();
+        return usage;
+    },
+
+    _queuedBytes() {
+        return (this.writableLength || 0) + (this.readableLength || 0);
+    },
+
+    // Report a change of the JS buffers to the running total of the context.
+    _syncQueued() {
+        if (!this._ctx._streams.has(this))
+            return;
+        const queued = this._queuedBytes();
+        this._ctx._queued += queued - this._queued;
+        this._queued = queued;
+    },
+
+    // Audio that does not fit in the memory budget of the context; returns
+    // the error the stream failed with, if any.
+    _refuse(size) {
+        if (this._ctx._overBudget === 'error') {
+            const err = new Error('Memory budget exceeded');
+            err.code = 'E_MEMORY_BUDGET';
+            this.destroy(err);
+            return err;
+        }
+        this.droppedBytes += size;
+        this.emit('dropped', size);
+        return null;
+    },
+
+    // Change the sample rate on the fly, for streams connected with the
+    // variable_rate flag; resolves once the server applied it.
+    async setRate(rate) {
+        await waitConnection(this);
+        return new Promise((resolve, reject) => {
+            this.$.update_rate(rate, (err) => err ? reject(err) : resolve());
+        });
+    }
+};
+
 /* Record Stream */
 
 class RecordStream extends Stream.Readable {
@@ -274,7 +625,12 @@ class RecordStream extends Stream.Readable {
         super(opts);
 
         this._read_cb = (chunk) => {
+            if (chunk && this._ctx._exceedsBudget(chunk.length)) {
+                this._refuse(chunk.length);
+                return;
+            }
             this.push(chunk);
+            this._syncQueued();
             // for some unknown reason, the following cleans correctly the references
             // it's necessary to avoid memory leak on chunks
             chunk = null;
@@ -286,6 +642,12 @@ class RecordStream extends Stream.Readable {
     _read(size) {
     }
 
+    read(size) {
+        const chunk = super.read(size);
+        this._syncQueued();
+        return chunk;
+    }
+
     stop() {
         this.$.read(null);
 
@@ -308,6 +670,149 @@ class RecordStream extends Stream.Readable {
         this.stop();
         this.push(null);
     }
+
+    // Only deliver speech to 'data', detected natively on energy and zero
+    // crossings; 'speechstart' and 'speechend' are emitted around it.
+    // Thresholds are in dBFS and dB, durations in microseconds.
+    vad(opts) {
+        if (opts === null || opts === false) {
+            this.$.vad(null);
+            return this;
+        }
+        opts = opts || {};
+        this.$.vad('threshold' in opts ? opts.threshold : -45,
+                   'margin' in opts ? opts.margin : 10,
+                   'zeroCrossings' in opts ? opts.zeroCrossings : 0.35,
+                   'hangover' in opts ? opts.hangover : 300000,
+                   'preroll' in opts ? opts.preroll : 200000);
+        return this;
+    }
+
+    // Compute spectra natively rather than pulling the audio into JS: every
+    // `hop` frames (or `rate` times per second), the last `size` frames are
+    // windowed and transformed, and 'spectrum' is emitted with the returned
+    // Float32Array, overwritten each time. It holds the magnitude of each of
+    // the size / 2 + 1 bins, or the energy in `bands` bands spaced
+    // logarithmically, in dB with the decibels option. Call stop() as well
+    // if the audio is not needed in JS.
+    async analyse(opts) {
+        await waitConnection(this);
+        if (opts === null || opts === false) {
+            this.$.analyser(null);
+            return null;
+        }
+        opts = opts || {};
+        const size = opts.size || 2048;
+        const bands = opts.bands || 0;
+        const hop = opts.rate ? Math.max(1, Math.round(this._rate / opts.rate)) : (opts.hop || size / 2);
+        const output = new Float32Array(bands || size / 2 + 1);
+        this.$.analyser(size, hop, bands, !!opts.decibels, output);
+        return output;
+    }
+
+    // Route the captured audio to a playback stream natively, without going
+    // through JS. Call stop() as well if the data is not needed in JS.
+    async link(playback, opts) {
+        opts = opts || {};
+        await Promise.all([waitConnection(this), waitConnection(playback)]);
+        // drift compensation: true, or the largest correction in ppm
+        const drift = opts.drift === true ? 1000 : (opts.drift || 0);
+        this.$.link(playback.$, 'gain' in opts ? opts.gain : 1, opts.latency || 0, drift);
+        return this;
+    }
+
+    unlink() {
+        this.$.link(null, 1, 0, 0);
+        return this;
+    }
+
+    // Write the captured audio to a file natively, from a thread of its own.
+    // 'recording' is emitted at every flush with the frames written and
+    // dropped so far; call stop() as well if the data is not needed in JS.
+    // A recording in progress is completed first.
+    async recordFile(path, opts) {
+        opts = opts || {};
+        await waitConnection(this);
+        if (this._recorded)
+            await this.stopRecording().catch(() => {});
+        this.$.record(path, opts.format !== 'raw',
+                      str2num(opts.sync, PulseStream.sync, PulseStream.sync.close),
+                      opts.buffer || 5000000, opts.flush || 1000000);
+        this._recording = true;
+        // 'recorded' is also emitted when a write error ends the recording
+        this._recorded = new Promise((resolve, reject) => {
+            this.once('recorded', (frames, dropped, error) => {
+                this._recording = false;
+                if (error)
+                    reject(new Error(error));
+                else
+                    resolve({ frames, dropped });
+            });
+        });
+        this._recorded.catch(() => {});
+        return this;
+    }
+
+    // Another consumer of the captured audio, as a readable stream. All
+    // consumers share the same chunks, which must not be modified. One that
+    // does not keep up queues up to `limit` bytes, then drops audio
+    // (the oldest by default) and counts it in `dropped`.
+    subscribe(opts) {
+        return new Subscription(this, opts);
+    }
+
+    // Resolves once the file is complete, with the frames written and dropped;
+    // rejects if writing failed, even if the recording had already ended.
+    stopRecording() {
+        if (!this._recorded)
+            return Promise.resolve(null);
+        const promise = this._recorded;
+        this._recorded = null;
+        if (this._recording)
+            this.$.record(null);
+        return promise;
+    }
+}
+
+/* Record Stream Subscription */
+
+class Subscription extends Stream.Readable {
+    constructor(stream, opts) {
+        opts = opts || {};
+        super({ highWaterMark: opts.highWaterMark });
+
+        this._stream = stream;
+        this._id = 0;
+
+        waitConnection(stream).then(() => {
+            if (this.destroyed)
+                return;
+            this._id = stream.$.subscribe((chunk) => this.push(chunk), opts.limit || 1048576,
+                                          str2num(opts.policy, PulseStream.overflow, PulseStream.overflow.drop_oldest));
+        }, (e) => {
+            this.destroy(e);
+        });
+        stream.once('close', () => {
+            this.push(null);
+        });
+    }
+
+    _read(size) {
+        if (this._id)
+            this._stream.$.resume_subscriber(this._id);
+    }
+
+    get dropped() {
+        const stats = this._id ? this._stream.$.subscriber_stats(this._id) : null;
+        return stats ? stats.dropped : 0;
+    }
+
+    _destroy(err, cb) {
+        if (this._id && this._stream._connected)
+            this._stream.$.unsubscribe(this._id);
+        this._id = 0;
+        cb(err);
+    }
 }
 
 /* Playback Stream */
@@ -320,8 +825,44 @@ class PlaybackStream extends Stream.Writable {
         this._writableState.discard = 0;
     }
 
-    async _write(chunk, encoding, done) {
+    write(chunk, encoding, cb) {
+        if (typeof encoding === 'function') {
+            cb = encoding;
+            encoding = undefined;
+        }
+        const size = chunk ? chunk.length : 0;
+        if (this._ctx._exceedsBudget(size)) {
+            const err = this._refuse(size);
+            if (cb)
+                process.nextTick(cb, err);
+            return !err;
+        }
+        const ret = super.write(chunk, encoding, cb);
+        this._syncQueued();
+        return ret;
+    }
+
+    // Writable.end(chunk) does not go through write(), so the last chunk
+    // would escape the budget.
+    end(chunk, encoding, cb) {
+        if (typeof chunk === 'function') {
+            cb = chunk;
+            chunk = null;
+        } else if (typeof encoding === 'function') {
+            cb = encoding;
+            encoding = undefined;
+        }
+        if (chunk !== null && chunk !== undefined)
+            this.write(chunk, encoding);
+        return super.end(cb);
+    }
+
+    async _write(chunk, encoding, callback) {
         const ws = this._writableState;
+        const done = (err) => {
+            callback(err);
+            this._syncQueued();
+        };
 
         if (ws.discard > 0) {
             ws.discard --;
@@ -332,10 +873,16 @@ class PlaybackStream extends Stream.Writable {
         try {
             await waitConnection(this);
 
-            if (this.playing)
+            if (this.playing) {
                 this.$.write(chunk, done);
-            else
+                if (this._triggerOnWrite) {
+                    // do not wait for the prebuffer of a warm stream to fill
+                    this._triggerOnWrite = false;
+                    this.$.trigger(() => {});
+                }
+            } else {
                 done();
+            }
         } catch(e) {
             done(e);
         }
@@ -365,6 +912,271 @@ class PlaybackStream extends Stream.Writable {
         if (this._connected)
             this.$.write(null, null);
     }
+
+    // Barge-in: drop everything queued and let the next chunk overwrite the
+    // audio already in the server buffer, crossfading into it, instead of
+    // flushing and waiting for the prebuffer to fill again. What is left of
+    // the old audio past a shorter chunk is silenced, and later writes
+    // follow the chunk.
+    replace(chunk, encoding, cb) {
+        var ws = this._writableState;
+
+        ws.discard = ws.bufferedRequestCount;
+
+        if (this._connected)
+            this.$.replace();
+
+        return this.write(chunk, encoding, cb);
+    }
+
+    // Start playback now, even if the prebuffer is not full yet.
+    async trigger() {
+        await waitConnection(this);
+        const [promise, cb] = makePromise(this);
+        this.$.trigger(cb);
+        return promise;
+    }
+
+    // Let the target latency follow how playback fares: it grows on
+    // underruns and when requests are served late, and shrinks back after
+    // `settle` microseconds without trouble, within [min, max] (in
+    // microseconds). 'latency' is emitted with each new target.
+    async adaptiveLatency(opts) {
+        await waitConnection(this);
+        if (opts === null || opts === false) {
+            this.$.adaptive(null);
+            return this;
+        }
+        opts = opts || {};
+        this.$.adaptive(opts.min || 10000, opts.max || 500000, opts.settle || 10000000);
+        return this;
+    }
+
+    // Cork the stream once it had nothing to play for `timeout` microseconds
+    // (or, with `silence`, only digital silence), so that the sink can
+    // suspend; the next write, file or packet uncorks it. 'idle' and
+    // 'active' are emitted around it. null or false turn it off.
+    async idleCork(opts) {
+        await waitConnection(this);
+        if (opts === null || opts === false) {
+            this.$.idle(null);
+            return this;
+        }
+        opts = opts || {};
+        this.$.idle(opts.timeout || 5000000, !!opts.silence);
+        return this;
+    }
+
+    // Play timestamped packets (e.g. from RTP) through a jitter buffer:
+    // packets are reordered by timestamp, in frames wrapping at 2^32, and
+    // played out with a delay that follows the measured jitter within
+    // [min, max] (in microseconds). Late packets are dropped and missing
+    // ones concealed. null or false go back to plain writes.
+    async jitterBuffer(opts) {
+        await waitConnection(this);
+        if (opts === null || opts === false) {
+            this.$.jitter(null);
+            return this;
+        }
+        opts = opts || {};
+        this.$.jitter(opts.min || 20000, opts.max || 500000);
+        return this;
+    }
+
+    pushPacket(timestamp, chunk) {
+        if (this._connected)
+            this.$.packet(timestamp >>> 0, chunk);
+        return this;
+    }
+
+    jitterStats() {
+        return this._connected ? this.$.jitter_stats() : null;
+    }
+
+    // Play a WAV or raw PCM file natively, from a memory mapping, without
+    // passing the audio through JS. The file must have the sample spec of
+    // the stream. 'played' is emitted once the whole file is queued, unless
+    // it loops; writing to the stream or stopFile() end it early.
+    // Resolves to the duration of the file, in seconds.
+    async playFile(path, opts) {
+        opts = opts || {};
+        await waitConnection(this);
+        const frames = this.$.play(path, !!opts.loop);
+        if (opts.start)
+            this.seekFile(opts.start);
+        return frames / this._rate;
+    }
+
+    seekFile(seconds) {
+        this.$.seek(Math.round(seconds * this._rate));
+        return this;
+    }
+
+    stopFile() {
+        if (this._connected)
+            this.$.stop();
+        return this;
+    }
+}
+
+/* Playback Stream Pool */
+
+function poolKey(opts) {
+    opts = opts || {};
+    return JSON.stringify([opts.format, opts.rate, opts.channels, opts.channelMap, opts.formats, opts.latency, opts.stream,
+                           opts.device, opts.flags, opts.properties, opts.highWaterMark]);
+}
+
+// Warm playback streams, connected with start_corked so that they do not
+// play nor request data until they are handed out and written to.
+class StreamPool {
+    constructor(ctx, opts) {
+        this._ctx = ctx;
+        this._opts = Object.assign({}, opts || {}, {
+            flags: (opts && opts.flags ? opts.flags + '|' : '') + 'start_corked'
+        });
+        this._size = 0;
+        this._pending = new Set();
+        this._ready = [];
+    }
+
+    _spawn() {
+        const stream = new PlaybackStream(this._ctx, this._opts);
+        const remove = () => {
+            this._pending.delete(stream);
+            const index = this._ready.indexOf(stream);
+            if (index >= 0) {
+                // a warm stream went away under us (eg. its sink vanished): replace it;
+                // streams that never connected are not retried to avoid spinning
+                this._ready.splice(index, 1);
+                this._fill();
+            }
+        };
+        const onConnection = () => {
+            this._pending.delete(stream);
+            if (this._ready.length >= this._size) {
+                // the pool shrank, or was torn down, meanwhile
+                this._detach(stream);
+                stream.end();
+                return;
+            }
+            this._ready.push(stream);
+        };
+        const onError = () => {
+            // a broken stream is simply not handed out
+            remove();
+        };
+
+        stream._pool = { onConnection, onError, remove };
+        stream.once('connection', onConnection);
+        stream.on('error', onError);
+        stream.once('close', remove);
+        this._pending.add(stream);
+    }
+
+    _detach(stream) {
+        stream.removeListener('connection', stream._pool.onConnection);
+        stream.removeListener('error', stream._pool.onError);
+        stream.removeListener('close', stream._pool.remove);
+        stream._pool = null;
+    }
+
+    _fill() {
+        while (this._ready.length + this._pending.size < this._size)
+            this._spawn();
+    }
+
+    resize(size) {
+        // streams still connecting are ended once connected, if not needed
+        // any more: ending them before would let them connect afterwards
+        this._size = size;
+        while (this._ready.length > size) {
+            const stream = this._ready.pop();
+            this._detach(stream);
+            stream.end();
+        }
+        this._fill();
+    }
+
+    acquire() {
+        const stream = this._ready.shift();
+        if (stream) {
+            this._detach(stream);
+            stream._triggerOnWrite = true;
+        }
+        this._fill();
+        return stream;
+    }
 }
 
+/* Playback Group */
+
+async function corkStream(stm, corked) {
+    await waitConnection(stm);
+    const [promise, cb] = makePromise(stm);
+    stm.$.cork(corked, cb);
+    return promise;
+}
+
+// Playback streams synchronized with the first one (the leader), through the
+// sync_stream argument of pa_stream_connect_playback: they must all play on
+// the same sink. They are held corked, so writing only prebuffers them, until
+// start() uncorks them all at once.
+class PlaybackGroup extends Events.EventEmitter {
+    constructor(ctx, list) {
+        super();
+
+        this.streams = [];
+        this.startTime = null;
+
+        for (const opts of list) {
+            const leader = this.streams[0];
+            const stream = new PlaybackStream(ctx, Object.assign({}, opts, {
+                device: opts.device || list[0].device,
+                flags: (opts.flags ? opts.flags + '|' : '') + 'start_corked',
+                sync: leader
+            }));
+            // registered before any write can wait for the connection
+            stream.once('connection', () => {
+                stream.$.cork(true, () => {});
+            });
+            stream.on('error', (e) => this.emit('error', e));
+            this.streams.push(stream);
+        }
+
+        // the time the leader, and thus every stream, started playing
+        this.streams[0].on('started', (time) => {
+            if (this.startTime !== null)
+                return;
+            this.startTime = time;
+            this.emit('start', time);
+        });
+    }
+
+    get leader() {
+        return this.streams[0];
+    }
+
+    async cork() {
+        this.startTime = null;
+        await Promise.all(this.streams.map((stream) => corkStream(stream, true)));
+    }
+
+    async uncork() {
+        await Promise.all(this.streams.map((stream) => corkStream(stream, false)));
+    }
+
+    start() {
+        return this.uncork();
+    }
+
+    end() {
+        for (const stream of this.streams)
+            stream.end();
+    }
+}
+
+Object.assign(RecordStream.prototype, streamMethods);
+Object.assign(PlaybackStream.prototype, streamMethods);
+
 module.exports = Context;
@@ -0,0 +1,61 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "adaptive-latency.hh"
+
+#include <algorithm>
+
+namespace pulse {
+  static const pa_usec_t min_step = 5000;
+
+  AdaptiveLatency::AdaptiveLatency(pa_usec_t min_, pa_usec_t max_, pa_usec_t settle_, pa_usec_t initial, double now) :
+    min(min_), max(std::max(min_, max_)), settle(settle_), target(std::min(std::max(initial, min), max)),
+    last_change(now) {}
+
+  bool AdaptiveLatency::set(pa_usec_t value, double now) {
+    value = std::min(std::max(value, min), max);
+    if (value == target)
+      return false;
+
+    target = value;
+    last_change = now;
+    return true;
+  }
+
+  bool AdaptiveLatency::underrun(double now) {
+    return set(std::max(target * 3 / 2, target + min_step), now);
+  }
+
+  bool AdaptiveLatency::request(double now, pa_usec_t lag, pa_usec_t buffered) {
+    /* let a change take effect before judging it */
+    if (now - last_change < target)
+      return false;
+
+    if (lag > target / 2 || buffered < target / 4)
+      return set(std::max(target * 5 / 4, target + min_step), now);
+
+    if (now - last_change >= settle) {
+      bool changed = set(target * 9 / 10, now);
+      /* at the floor, start another quiet period all the same */
+      last_change = now;
+      return changed;
+    }
+
+    return false;
+  }
+}
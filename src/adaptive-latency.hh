@@ -0,0 +1,54 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __ADAPTIVE_LATENCY_HH__
+#define __ADAPTIVE_LATENCY_HH__
+
+#include "common.hh"
+
+namespace pulse {
+  /* Picks the target latency of a playback stream from how it fares: an
+     underrun grows it by half, signs of trouble (a request served late by
+     a busy event loop, or the server buffer running low) by a quarter, at
+     most once per target period. After a quiet settle period it shrinks
+     by a tenth, and again after each further quiet period. */
+  class AdaptiveLatency {
+  private:
+    pa_usec_t min;
+    pa_usec_t max;
+    pa_usec_t settle;
+    pa_usec_t target;
+
+    double last_change; /* usec, monotonic */
+
+    bool set(pa_usec_t value, double now);
+
+  public:
+    AdaptiveLatency(pa_usec_t min, pa_usec_t max, pa_usec_t settle, pa_usec_t initial, double now);
+
+    pa_usec_t value() const {
+      return target;
+    }
+
+    /* each returns true when the target changed */
+    bool underrun(double now);
+    bool request(double now, pa_usec_t lag, pa_usec_t buffered);
+  };
+}
+
+#endif//__ADAPTIVE_LATENCY_HH__
@@ -0,0 +1,199 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "analyser.hh"
+#include "sample.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pulse {
+  static const float min_frequency = 20.0f;
+
+  Analyser::Analyser(const pa_sample_spec& ss_, size_t size_, size_t hop_, size_t bands_, bool decibels_) :
+    ss(ss_), size(size_), hop(std::max<size_t>(1, hop_)), bands(bands_), decibels(decibels_),
+    history(size_, 0.0f), pos(0), countdown(hop), produced(false) {
+    size_t half = size / 2;
+
+    /* periodic Hann window */
+    window.resize(size);
+    float sum = 0.0f;
+    for (size_t i = 0; i < size; i++) {
+      window[i] = 0.5f - 0.5f * std::cos(2.0f * float(M_PI) * float(i) / float(size));
+      sum += window[i];
+    }
+    norm = 2.0f / sum;
+
+    size_t bits = 0;
+    while ((size_t(1) << bits) < half)
+      bits++;
+    reversed.resize(half);
+    for (size_t i = 0; i < half; i++) {
+      size_t r = 0;
+      for (size_t b = 0; b < bits; b++)
+        r |= ((i >> b) & 1) << (bits - 1 - b);
+      reversed[i] = uint32_t(r);
+    }
+
+    /* angles 2πk/size, for the real split; the FFT of size / 2 uses the even ones */
+    cos_table.resize(half);
+    sin_table.resize(half);
+    for (size_t k = 0; k < half; k++) {
+      double a = 2.0 * M_PI * double(k) / double(size);
+      cos_table[k] = float(std::cos(a));
+      sin_table[k] = float(std::sin(a));
+    }
+
+    re.resize(half);
+    im.resize(half);
+    power.resize(half + 1);
+
+    if (bands) {
+      size_t lo = std::max<size_t>(1, size_t(std::lround(min_frequency * float(size) / float(ss.rate))));
+      lo = std::min(lo, half);
+      edges.resize(bands + 1);
+      for (size_t b = 0; b < bands; b++) {
+        size_t e = size_t(std::lround(float(lo) * std::pow(float(half + 1) / float(lo), float(b) / float(bands))));
+        if (b > 0)
+          e = std::max(e, size_t(edges[b - 1]) + 1);
+        edges[b] = uint32_t(std::min(e, half + 1));
+      }
+      edges[bands] = uint32_t(half + 1);
+      output.resize(bands);
+    } else {
+      output.resize(half + 1);
+    }
+  }
+
+  size_t Analyser::memory() const {
+    return (history.size() + window.size() + cos_table.size() + sin_table.size() + re.size() + im.size() +
+            power.size() + output.size() + scratch.capacity()) * sizeof(float) +
+      (reversed.size() + edges.size()) * sizeof(uint32_t);
+  }
+
+  /* iterative radix-2, on data in bit-reversed order */
+  void Analyser::fft() {
+    const size_t n = re.size();
+    float *r = re.data();
+    float *i = im.data();
+
+    for (size_t len = 2; len <= n; len <<= 1) {
+      const size_t half = len / 2;
+      const size_t step = size / len;
+
+      for (size_t start = 0; start < n; start += len) {
+        float *ar = r + start, *ai = i + start;
+        float *br = ar + half, *bi = ai + half;
+
+        for (size_t j = 0; j < half; j++) {
+          float wr = cos_table[j * step];
+          float wi = -sin_table[j * step];
+          float tr = br[j] * wr - bi[j] * wi;
+          float ti = br[j] * wi + bi[j] * wr;
+          br[j] = ar[j] - tr;
+          bi[j] = ai[j] - ti;
+          ar[j] += tr;
+          ai[j] += ti;
+        }
+      }
+    }
+  }
+
+  void Analyser::transform() {
+    const size_t half = size / 2;
+
+    /* even samples as the real part, odd ones as the imaginary part, oldest first */
+    for (size_t n = 0; n < half; n++) {
+      size_t t = 2 * n;
+      size_t a = (pos + t) & (size - 1);
+      size_t b = (pos + t + 1) & (size - 1);
+      re[reversed[n]] = history[a] * window[t];
+      im[reversed[n]] = history[b] * window[t + 1];
+    }
+
+    fft();
+
+    /* spectrum of the real signal from that of its halves */
+    const float scale = norm * norm;
+    power[0] = (re[0] + im[0]) * (re[0] + im[0]) * scale;
+    power[half] = (re[0] - im[0]) * (re[0] - im[0]) * scale;
+    for (size_t k = 1; k < half; k++) {
+      float ar = re[k], ai = im[k];
+      float br = re[half - k], bi = im[half - k];
+
+      float er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+      float or_ = 0.5f * (ai + bi), oi = -0.5f * (ar - br);
+      float c = cos_table[k], s = sin_table[k];
+
+      float xr = er + c * or_ + s * oi;
+      float xi = ei + c * oi - s * or_;
+      power[k] = (xr * xr + xi * xi) * scale;
+    }
+
+    if (bands) {
+      for (size_t b = 0; b < bands; b++) {
+        float e = 0.0f;
+        for (size_t k = edges[b]; k < edges[b + 1]; k++)
+          e += power[k];
+        output[b] = e;
+      }
+      if (decibels)
+        for (size_t b = 0; b < bands; b++)
+          output[b] = 10.0f * std::log10(output[b] + 1e-12f);
+    } else if (decibels) {
+      for (size_t k = 0; k <= half; k++)
+        output[k] = 10.0f * std::log10(power[k] + 1e-12f);
+    } else {
+      for (size_t k = 0; k <= half; k++)
+        output[k] = std::sqrt(power[k]);
+    }
+  }
+
+  size_t Analyser::analyse(const void *data, size_t bytes) {
+    size_t frame_size = pa_frame_size(&ss);
+    size_t frames = std::min(bytes / frame_size, countdown);
+
+    produced = false;
+    if (!frames)
+      return 0;
+
+    size_t samples = frames * ss.channels;
+    if (scratch.size() < samples)
+      scratch.resize(samples);
+    samples_to_float(ss.format, data, scratch.data(), samples);
+
+    const float *s = scratch.data();
+    const float scale = 1.0f / float(ss.channels);
+    for (size_t f = 0; f < frames; f++, s += ss.channels) {
+      float v = 0.0f;
+      for (unsigned c = 0; c < ss.channels; c++)
+        v += s[c];
+      history[pos] = v * scale;
+      pos = (pos + 1) & (size - 1);
+    }
+
+    countdown -= frames;
+    if (!countdown) {
+      countdown = hop;
+      transform();
+      produced = true;
+    }
+
+    return frames * frame_size;
+  }
+}
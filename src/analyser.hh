@@ -0,0 +1,96 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __ANALYSER_HH__
+#define __ANALYSER_HH__
+
+#include "common.hh"
+
+namespace pulse {
+  /* Spectrum analyser. The channels are mixed down, and every `hop` frames
+     the last `size` frames (a power of two) go through a Hann window and a
+     real FFT, computed as a complex FFT of half the size. The result is
+     either the magnitude of each bin, 1.0 for a full scale sine, or the
+     energy in `bands` bands spaced logarithmically from 20Hz to Nyquist,
+     optionally in dB.
+
+     The loops work on separate real and imaginary arrays, so that the
+     compiler can vectorize them. */
+  class Analyser {
+  private:
+    pa_sample_spec ss;
+    size_t size;
+    size_t hop;
+    size_t bands;
+    bool decibels;
+
+    /* input, a ring of the last `size` mono samples */
+    std::vector<float> history;
+    size_t pos;
+    size_t countdown;        /* frames until the next spectrum */
+    bool produced;
+
+    std::vector<float> window;
+    float norm;              /* magnitude scale, for 1.0 at full scale */
+
+    /* FFT of size / 2 */
+    std::vector<uint32_t> reversed;
+    std::vector<float> cos_table;
+    std::vector<float> sin_table;
+    std::vector<float> re;
+    std::vector<float> im;
+
+    std::vector<float> power;
+    std::vector<uint32_t> edges;  /* first bin of each band, and the end */
+    std::vector<float> output;
+    std::vector<float> scratch;
+
+    void fft();
+    void transform();
+
+  public:
+    /* size must be a power of two, at least 4 */
+    Analyser(const pa_sample_spec& ss, size_t size, size_t hop, size_t bands, bool decibels);
+
+    Analyser(const Analyser&) = delete;
+    Analyser& operator=(const Analyser&) = delete;
+
+    static bool valid_size(size_t size) {
+      return size >= 4 && size <= (1 << 16) && (size & (size - 1)) == 0;
+    }
+
+    /* length of the output, in values */
+    size_t length() const {
+      return output.size();
+    }
+
+    /* consumes audio up to the end of the next spectrum and returns the
+       bytes used; ready() tells whether a spectrum was completed */
+    size_t analyse(const void *data, size_t size);
+
+    bool ready() const {
+      return produced;
+    }
+    const float *spectrum() const {
+      return output.data();
+    }
+    size_t memory() const;
+  };
+}
+
+#endif//__ANALYSER_HH__
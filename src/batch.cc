@@ -0,0 +1,357 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "batch.hh"
+
+#include <cstring>
+
+namespace pulse {
+  Batch::Step::Step(BatchOp op_) :
+    op(op_), target(INFO_SINK_LIST), index(PA_INVALID_INDEX), device(PA_INVALID_INDEX), mute(0),
+    failed(false), loaded(PA_INVALID_INDEX), rolled_back(false), saved(false), saved_mute(0), saved_device(PA_INVALID_INDEX), batch(NULL) {
+    memset(&volume, 0, sizeof(volume));
+    memset(&saved_volume, 0, sizeof(saved_volume));
+  }
+
+  Batch::Batch(pa_context *c_, std::vector<Step>&& steps_, bool rollback_, Pending *pending_) :
+    c(c_), steps(std::move(steps_)), rollback(rollback_), pending(pending_), phase(BATCH_SAVING), outstanding(0) {
+    for (auto& step : steps)
+      step.batch = this;
+  }
+
+  /* the same operation on a sink, a source or a sink input */
+
+  static pa_operation *set_volume(pa_context *c, InfoType target, uint32_t index, const std::string& name, const pa_cvolume *volume,
+                                  pa_context_success_cb_t cb, void *ud) {
+    switch(target) {
+    case INFO_SINK_LIST:
+      return name.empty() ? pa_context_set_sink_volume_by_index(c, index, volume, cb, ud) :
+        pa_context_set_sink_volume_by_name(c, name.c_str(), volume, cb, ud);
+    case INFO_SOURCE_LIST:
+      return name.empty() ? pa_context_set_source_volume_by_index(c, index, volume, cb, ud) :
+        pa_context_set_source_volume_by_name(c, name.c_str(), volume, cb, ud);
+    case INFO_SINK_INPUT_LIST:
+      return pa_context_set_sink_input_volume(c, index, volume, cb, ud);
+    default:
+      return NULL;
+    }
+  }
+
+  static pa_operation *set_mute(pa_context *c, InfoType target, uint32_t index, const std::string& name, int mute,
+                                pa_context_success_cb_t cb, void *ud) {
+    switch(target) {
+    case INFO_SINK_LIST:
+      return name.empty() ? pa_context_set_sink_mute_by_index(c, index, mute, cb, ud) :
+        pa_context_set_sink_mute_by_name(c, name.c_str(), mute, cb, ud);
+    case INFO_SOURCE_LIST:
+      return name.empty() ? pa_context_set_source_mute_by_index(c, index, mute, cb, ud) :
+        pa_context_set_source_mute_by_name(c, name.c_str(), mute, cb, ud);
+    case INFO_SINK_INPUT_LIST:
+      return pa_context_set_sink_input_mute(c, index, mute, cb, ud);
+    default:
+      return NULL;
+    }
+  }
+
+  void Batch::run() {
+    if (rollback)
+      save();
+    else
+      apply();
+  }
+
+  void Batch::issued(Step& step, pa_operation *op) {
+    if (op) {
+      outstanding++;
+      pa_operation_unref(op);
+    } else if (phase == BATCH_APPLYING) {
+      step.failed = true;
+      step.error = pa_strerror(pa_context_errno(c));
+    }
+  }
+
+  /* one reply less to wait for, moves to the next phase after the last */
+  void Batch::done() {
+    if (--outstanding > 0)
+      return;
+
+    switch(phase) {
+    case BATCH_SAVING:
+      apply();
+      break;
+    case BATCH_APPLYING:
+      for (auto& step : steps) {
+        if (step.failed && rollback) {
+          undo();
+          return;
+        }
+      }
+      finish();
+      break;
+    case BATCH_UNDOING:
+      finish();
+      break;
+    }
+  }
+
+  /* save */
+
+  void Batch::save() {
+    phase = BATCH_SAVING;
+
+    for (auto& step : steps) {
+      pa_operation *op = NULL;
+
+      switch(step.op) {
+      case BATCH_LOAD_MODULE:
+        /* undone with the index it returns */
+        continue;
+      case BATCH_UNLOAD_MODULE:
+        op = pa_context_get_module_info(c, step.index, SavedModule, &step);
+        break;
+      case BATCH_SET_VOLUME:
+      case BATCH_SET_MUTE:
+        switch(step.target) {
+        case INFO_SINK_LIST:
+          op = step.name.empty() ? pa_context_get_sink_info_by_index(c, step.index, SavedDevice<pa_sink_info>, &step) :
+            pa_context_get_sink_info_by_name(c, step.name.c_str(), SavedDevice<pa_sink_info>, &step);
+          break;
+        case INFO_SOURCE_LIST:
+          op = step.name.empty() ? pa_context_get_source_info_by_index(c, step.index, SavedDevice<pa_source_info>, &step) :
+            pa_context_get_source_info_by_name(c, step.name.c_str(), SavedDevice<pa_source_info>, &step);
+          break;
+        case INFO_SINK_INPUT_LIST:
+          op = pa_context_get_sink_input_info(c, step.index, SavedSinkInput, &step);
+          break;
+        default:
+          break;
+        }
+        break;
+      case BATCH_MOVE_SINK_INPUT:
+        op = pa_context_get_sink_input_info(c, step.index, SavedSinkInput, &step);
+        break;
+      case BATCH_MOVE_SOURCE_OUTPUT:
+        op = pa_context_get_source_output_info(c, step.index, SavedSourceOutput, &step);
+        break;
+      }
+
+      /* a step whose state cannot be read is not undone */
+      issued(step, op);
+    }
+
+    if (!outstanding)
+      apply();
+  }
+
+  template<typename Info>
+  void Batch::SavedDevice(pa_context *c, const Info *i, int eol, void *ud) {
+    Step *step = static_cast<Step*>(ud);
+
+    if (!eol && i) {
+      step->saved_volume = i->volume;
+      step->saved_mute = i->mute;
+      step->saved = true;
+    }
+    if (eol)
+      step->batch->done();
+  }
+
+  void Batch::SavedSinkInput(pa_context *c, const pa_sink_input_info *i, int eol, void *ud) {
+    Step *step = static_cast<Step*>(ud);
+
+    if (!eol && i) {
+      step->saved_volume = i->volume;
+      step->saved_mute = i->mute;
+      step->saved_device = i->sink;
+      step->saved = true;
+    }
+    if (eol)
+      step->batch->done();
+  }
+
+  void Batch::SavedSourceOutput(pa_context *c, const pa_source_output_info *i, int eol, void *ud) {
+    Step *step = static_cast<Step*>(ud);
+
+    if (!eol && i) {
+      step->saved_device = i->source;
+      step->saved = true;
+    }
+    if (eol)
+      step->batch->done();
+  }
+
+  void Batch::SavedModule(pa_context *c, const pa_module_info *i, int eol, void *ud) {
+    Step *step = static_cast<Step*>(ud);
+
+    if (!eol && i) {
+      step->saved_name = i->name;
+      step->saved_argument = i->argument ? i->argument : "";
+      step->saved = true;
+    }
+    if (eol)
+      step->batch->done();
+  }
+
+  /* apply */
+
+  void Batch::apply() {
+    phase = BATCH_APPLYING;
+
+    for (auto& step : steps) {
+      pa_operation *op = NULL;
+
+      switch(step.op) {
+      case BATCH_LOAD_MODULE:
+        op = pa_context_load_module(c, step.name.c_str(), step.argument.c_str(), AppliedIndex, &step);
+        break;
+      case BATCH_UNLOAD_MODULE:
+        op = pa_context_unload_module(c, step.index, Applied, &step);
+        break;
+      case BATCH_SET_VOLUME:
+        op = set_volume(c, step.target, step.index, step.name, &step.volume, Applied, &step);
+        break;
+      case BATCH_SET_MUTE:
+        op = set_mute(c, step.target, step.index, step.name, step.mute, Applied, &step);
+        break;
+      case BATCH_MOVE_SINK_INPUT:
+        op = step.name.empty() ? pa_context_move_sink_input_by_index(c, step.index, step.device, Applied, &step) :
+          pa_context_move_sink_input_by_name(c, step.index, step.name.c_str(), Applied, &step);
+        break;
+      case BATCH_MOVE_SOURCE_OUTPUT:
+        op = step.name.empty() ? pa_context_move_source_output_by_index(c, step.index, step.device, Applied, &step) :
+          pa_context_move_source_output_by_name(c, step.index, step.name.c_str(), Applied, &step);
+        break;
+      }
+
+      issued(step, op);
+    }
+
+    if (!outstanding) {
+      /* nothing could be issued, there is nothing to undo either */
+      finish();
+    }
+  }
+
+  void Batch::Applied(pa_context *c, int success, void *ud) {
+    Step *step = static_cast<Step*>(ud);
+
+    if (!success) {
+      step->failed = true;
+      step->error = pa_strerror(pa_context_errno(c));
+    }
+    step->batch->done();
+  }
+
+  void Batch::AppliedIndex(pa_context *c, uint32_t index, void *ud) {
+    Step *step = static_cast<Step*>(ud);
+
+    if (index == PA_INVALID_INDEX) {
+      step->failed = true;
+      step->error = pa_strerror(pa_context_errno(c));
+    } else {
+      step->loaded = index;
+    }
+    step->batch->done();
+  }
+
+  /* rollback */
+
+  void Batch::undo() {
+    phase = BATCH_UNDOING;
+
+    for (auto step = steps.rbegin(); step != steps.rend(); ++step) {
+      if (step->failed)
+        continue;
+
+      pa_operation *op = NULL;
+      void *ud = &*step;
+
+      switch(step->op) {
+      case BATCH_LOAD_MODULE:
+        op = pa_context_unload_module(c, step->loaded, Undone, ud);
+        break;
+      case BATCH_UNLOAD_MODULE:
+        if (step->saved)
+          op = pa_context_load_module(c, step->saved_name.c_str(), step->saved_argument.c_str(), UndoneIndex, ud);
+        break;
+      case BATCH_SET_VOLUME:
+        if (step->saved)
+          op = set_volume(c, step->target, step->index, step->name, &step->saved_volume, Undone, ud);
+        break;
+      case BATCH_SET_MUTE:
+        if (step->saved)
+          op = set_mute(c, step->target, step->index, step->name, step->saved_mute, Undone, ud);
+        break;
+      case BATCH_MOVE_SINK_INPUT:
+        if (step->saved)
+          op = pa_context_move_sink_input_by_index(c, step->index, step->saved_device, Undone, ud);
+        break;
+      case BATCH_MOVE_SOURCE_OUTPUT:
+        if (step->saved)
+          op = pa_context_move_source_output_by_index(c, step->index, step->saved_device, Undone, ud);
+        break;
+      }
+
+      issued(*step, op);
+    }
+
+    if (!outstanding)
+      finish();
+  }
+
+  void Batch::Undone(pa_context *c, int success, void *ud) {
+    Step *step = static_cast<Step*>(ud);
+
+    step->rolled_back = success;
+    step->batch->done();
+  }
+
+  void Batch::UndoneIndex(pa_context *c, uint32_t index, void *ud) {
+    Step *step = static_cast<Step*>(ud);
+
+    step->rolled_back = index != PA_INVALID_INDEX;
+    step->batch->done();
+  }
+
+  /* results */
+
+  void Batch::finish() {
+    Nan::HandleScope scope;
+
+    auto results = Nan::New<v8::Array>(steps.size());
+    for (size_t i = 0; i < steps.size(); i++) {
+      const Step& step = steps[i];
+      auto result = Nan::New<v8::Object>();
+
+      if (step.op == BATCH_LOAD_MODULE && !step.failed)
+        Nan::Set(result, Nan::New("index").ToLocalChecked(), Nan::New(step.loaded));
+      if (step.failed)
+        Nan::Set(result, Nan::New("error").ToLocalChecked(), Nan::New(step.error).ToLocalChecked());
+      if (rollback)
+        Nan::Set(result, Nan::New("rolledBack").ToLocalChecked(), Nan::New(step.rolled_back));
+
+      Nan::Set(results, uint32_t(i), result);
+    }
+
+    pending->Args(1);
+    pending->argv[0] = Nan::Global<v8::Value>(results);
+    pending->Return();
+
+    delete this;
+  }
+}
@@ -0,0 +1,116 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __BATCH_HH__
+#define __BATCH_HH__
+
+#include "common.hh"
+#include "context.hh"
+
+#include <string>
+
+namespace pulse {
+  enum BatchOp {
+    BATCH_LOAD_MODULE,
+    BATCH_UNLOAD_MODULE,
+    BATCH_SET_VOLUME,
+    BATCH_SET_MUTE,
+    BATCH_MOVE_SINK_INPUT,
+    BATCH_MOVE_SOURCE_OUTPUT
+  };
+
+  /* Control operations issued back to back, without waiting for each
+     reply, so that the whole list costs a single round trip; the results
+     of every step are returned at once. With rollback, what the steps
+     replace is read first (one more round trip), and when a step fails the
+     steps that succeeded are undone, in reverse order.
+
+     The batch deletes itself once its callback is called. */
+  class Batch {
+  public:
+    struct Step {
+      BatchOp op;
+      InfoType target;       /* sink, source or sink input, for volume and mute */
+      uint32_t index;        /* target, module or stream */
+      std::string name;      /* target, module or destination, instead of an index */
+      std::string argument;  /* module argument */
+      uint32_t device;       /* destination of a move, by index */
+      pa_cvolume volume;
+      int mute;
+
+      /* result */
+      bool failed;
+      std::string error;
+      uint32_t loaded;       /* index of the loaded module */
+      bool rolled_back;
+
+      /* what the step replaces, for the rollback */
+      bool saved;
+      pa_cvolume saved_volume;
+      int saved_mute;
+      uint32_t saved_device;
+      std::string saved_name;
+      std::string saved_argument;
+
+      Batch *batch;
+
+      explicit Step(BatchOp op);
+    };
+
+  private:
+    enum Phase {
+      BATCH_SAVING,
+      BATCH_APPLYING,
+      BATCH_UNDOING
+    };
+
+    pa_context *c;
+    std::vector<Step> steps;
+    bool rollback;
+    std::unique_ptr<Pending> pending;
+
+    Phase phase;
+    unsigned outstanding;
+
+    void save();
+    void apply();
+    void undo();
+    void issued(Step& step, pa_operation *op);
+    void done();
+    void finish();
+
+    template<typename Info> static void SavedDevice(pa_context *c, const Info *i, int eol, void *ud);
+    static void SavedSinkInput(pa_context *c, const pa_sink_input_info *i, int eol, void *ud);
+    static void SavedSourceOutput(pa_context *c, const pa_source_output_info *i, int eol, void *ud);
+    static void SavedModule(pa_context *c, const pa_module_info *i, int eol, void *ud);
+    static void Applied(pa_context *c, int success, void *ud);
+    static void AppliedIndex(pa_context *c, uint32_t index, void *ud);
+    static void Undone(pa_context *c, int success, void *ud);
+    static void UndoneIndex(pa_context *c, uint32_t index, void *ud);
+
+  public:
+    Batch(pa_context *c, std::vector<Step>&& steps, bool rollback, Pending *pending);
+
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+
+    void run();
+  };
+}
+
+#endif//__BATCH_HH__
@@ -0,0 +1,139 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "biquad.hh"
+
+#include <cmath>
+
+namespace pulse {
+  Equalizer::Equalizer(unsigned rate, unsigned channels) : rate(rate), channels(channels) {}
+
+  bool Equalizer::set(size_t index, FilterType type, double frequency, double q, double gain) {
+    if (index > sections.size() || frequency <= 0 || frequency >= rate / 2.0 || q <= 0)
+      return false;
+
+    if (index == sections.size()) {
+      sections.emplace_back();
+      sections.back().z1.assign(channels, 0.0f);
+      sections.back().z2.assign(channels, 0.0f);
+    }
+
+    Section& s = sections[index];
+    s.type = type;
+    s.frequency = frequency;
+    s.q = q;
+    s.gain = gain;
+    design(s);
+    return true;
+  }
+
+  void Equalizer::truncate(size_t count) {
+    if (count < sections.size())
+      sections.resize(count);
+  }
+
+  void Equalizer::design(Section& s) {
+    const double w0 = 2 * M_PI * s.frequency / rate;
+    const double cosw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2 * s.q);
+    const double A = std::pow(10.0, s.gain / 40);
+    double b0, b1, b2, a0, a1, a2;
+
+    switch (s.type) {
+    case FILTER_LOWPASS:
+      b0 = (1 - cosw) / 2; b1 = 1 - cosw; b2 = b0;
+      a0 = 1 + alpha; a1 = -2 * cosw; a2 = 1 - alpha;
+      break;
+    case FILTER_HIGHPASS:
+      b0 = (1 + cosw) / 2; b1 = -(1 + cosw); b2 = b0;
+      a0 = 1 + alpha; a1 = -2 * cosw; a2 = 1 - alpha;
+      break;
+    case FILTER_BANDPASS:
+      b0 = alpha; b1 = 0; b2 = -alpha;
+      a0 = 1 + alpha; a1 = -2 * cosw; a2 = 1 - alpha;
+      break;
+    case FILTER_NOTCH:
+      b0 = 1; b1 = -2 * cosw; b2 = 1;
+      a0 = 1 + alpha; a1 = -2 * cosw; a2 = 1 - alpha;
+      break;
+    case FILTER_PEAKING:
+      b0 = 1 + alpha * A; b1 = -2 * cosw; b2 = 1 - alpha * A;
+      a0 = 1 + alpha / A; a1 = -2 * cosw; a2 = 1 - alpha / A;
+      break;
+    case FILTER_LOWSHELF: {
+      const double sq = 2 * std::sqrt(A) * alpha;
+      b0 = A * ((A + 1) - (A - 1) * cosw + sq);
+      b1 = 2 * A * ((A - 1) - (A + 1) * cosw);
+      b2 = A * ((A + 1) - (A - 1) * cosw - sq);
+      a0 = (A + 1) + (A - 1) * cosw + sq;
+      a1 = -2 * ((A - 1) + (A + 1) * cosw);
+      a2 = (A + 1) + (A - 1) * cosw - sq;
+      break;
+    }
+    case FILTER_HIGHSHELF:
+    default: {
+      const double sq = 2 * std::sqrt(A) * alpha;
+      b0 = A * ((A + 1) + (A - 1) * cosw + sq);
+      b1 = -2 * A * ((A - 1) + (A + 1) * cosw);
+      b2 = A * ((A + 1) + (A - 1) * cosw - sq);
+      a0 = (A + 1) - (A - 1) * cosw + sq;
+      a1 = 2 * ((A - 1) - (A + 1) * cosw);
+      a2 = (A + 1) - (A - 1) * cosw - sq;
+      break;
+    }
+    }
+
+    s.b0 = float(b0 / a0);
+    s.b1 = float(b1 / a0);
+    s.b2 = float(b2 / a0);
+    s.a1 = float(a1 / a0);
+    s.a2 = float(a2 / a0);
+  }
+
+  /* The recursion is serial in time, so the inner loop goes across the
+     channels of a frame, where the compiler can vectorize it. */
+  void Equalizer::run(Section& s, float *data, size_t frames) {
+    const float b0 = s.b0, b1 = s.b1, b2 = s.b2, a1 = s.a1, a2 = s.a2;
+    float *__restrict z1 = s.z1.data();
+    float *__restrict z2 = s.z2.data();
+    const unsigned n = channels;
+
+    for (size_t f = 0; f < frames; f++, data += n) {
+      for (unsigned c = 0; c < n; c++) {
+        const float x = data[c];
+        const float y = b0 * x + z1[c];
+        z1[c] = b1 * x - a1 * y + z2[c];
+        z2[c] = b2 * x - a2 * y;
+        data[c] = y;
+      }
+    }
+
+    /* keep the state out of denormals once the input goes silent */
+    for (unsigned c = 0; c < n; c++) {
+      if (std::fabs(z1[c]) < 1e-15f)
+        z1[c] = 0.0f;
+      if (std::fabs(z2[c]) < 1e-15f)
+        z2[c] = 0.0f;
+    }
+  }
+
+  void Equalizer::process(float *data, size_t frames) {
+    for (Section& s : sections)
+      run(s, data, frames);
+  }
+}
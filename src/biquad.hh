@@ -0,0 +1,76 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __BIQUAD_HH__
+#define __BIQUAD_HH__
+
+#include <cstddef>
+#include <vector>
+
+namespace pulse {
+  enum FilterType {
+    FILTER_LOWPASS,
+    FILTER_HIGHPASS,
+    FILTER_BANDPASS,
+    FILTER_NOTCH,
+    FILTER_PEAKING,
+    FILTER_LOWSHELF,
+    FILTER_HIGHSHELF
+  };
+
+  /* A chain of biquad sections (RBJ cookbook designs), run in transposed
+     direct form II on interleaved float samples. Sections can be changed
+     at runtime: their coefficients are recomputed, but the filter state is
+     kept, so that an update does not click. */
+  class Equalizer {
+  private:
+    struct Section {
+      FilterType type;
+      double frequency;
+      double q;
+      double gain;
+      float b0, b1, b2, a1, a2;
+      std::vector<float> z1, z2;
+    };
+
+    unsigned rate;
+    unsigned channels;
+    std::vector<Section> sections;
+
+    void design(Section& s);
+    void run(Section& s, float *data, size_t frames);
+
+  public:
+    Equalizer(unsigned rate, unsigned channels);
+
+    /* index may be the current size, to append a section */
+    bool set(size_t index, FilterType type, double frequency, double q, double gain);
+    void truncate(size_t count);
+
+    size_t size() const {
+      return sections.size();
+    }
+    bool active() const {
+      return !sections.empty();
+    }
+
+    void process(float *data, size_t frames);
+  };
+}
+
+#endif//__BIQUAD_HH__
@@ -29,8 +29,10 @@ extern "C" {
 #include <node.h>
 #include <uv.h>
 #include <memory>
+#include <vector>
 
 #include "debug.hh"
+#include "probes.hh"
 
 //#include <string>
 //#include <sstream>
@@ -116,6 +118,34 @@ namespace pulse {
 
     return props;
   }
+
+  class Pending {
+  public:
+    v8::Isolate *isolate;
+    Nan::Global<v8::Object> self;
+    Nan::Global<v8::Function> callback;
+    std::vector<Nan::Global<v8::Value>> argv;
+
+    Pending(v8::Isolate *isolate_, v8::Local<v8::Object> self_, v8::Local<v8::Function> callback_) : isolate(isolate_),
+        self(self_), callback(callback_) {}
+    Pending(const Pending&) = delete;
+    Pending(Pending&&) = delete;
+    Pending& operator=(const Pending&) = delete;
+    Pending&& operator=(Pending&&) = delete;
+
+    size_t Args() {
+      return argv.size();
+    }
+    void Args(size_t num) {
+      argv.resize(num);
+    }
+    void Return() {
+      std::vector<v8::Local<v8::Value>> local_argv(argv.size());
+      for (size_t i = 0; i < argv.size(); i++)
+        local_argv[i] = argv[i].Get(isolate);
+      Nan::MakeCallback(self.Get(isolate), callback.Get(isolate), local_argv.size(), &local_argv.front());
+    }
+  };
 }
 
 #endif//__COMMON_HH__
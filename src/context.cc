@@ -18,10 +18,14 @@
 // along with this library. If not, see <http://www.gnu.org/licenses/>.
 
 #include "context.hh"
+#include "batch.hh"
+
+#include <cstdlib>
 
 namespace pulse {
   
-  Context::Context(v8::Isolate *isolate, const Nan::Utf8String *client_name, pa_proplist *props) : isolate(isolate) {
+  Context::Context(v8::Isolate *isolate, const Nan::Utf8String *client_name, pa_proplist *props) :
+    isolate(isolate), memory(0), queued(0), memory_budget(0) {
     pa_ctx = pa_context_new_with_proplist(&mainloop_api, client_name ? **client_name : "node-pulse", props);
     pa_context_set_state_callback(pa_ctx, StateCallback, this);
   }
@@ -72,34 +76,6 @@ namespace pulse {
     
   }
   
-  class Pending {
-  public:
-    v8::Isolate *isolate;
-    Nan::Global<v8::Object> self;
-    Nan::Global<v8::Function> callback;
-    std::vector<Nan::Global<v8::Value>> argv;
-
-    Pending(v8::Isolate *isolate_, v8::Local<v8::Object> self_, v8::Local<v8::Function> callback_) : isolate(isolate_),
-        self(self_), callback(callback_) {}
-    Pending(const Pending&) = delete;
-    Pending(Pending&&) = delete;
-    Pending& operator=(const Pending&) = delete;
-    Pending&& operator=(Pending&&) = delete;
-
-    size_t Args() {
-      return argv.size();
-    }
-    void Args(size_t num) {
-      argv.resize(num);
-    }
-    void Return() {
-      std::vector<v8::Local<v8::Value>> local_argv(argv.size());
-      for (size_t i = 0; i < argv.size(); i++)
-        local_argv[i] = argv[i].Get(isolate);
-      Nan::MakeCallback(self.Get(isolate), callback.Get(isolate), local_argv.size(), &local_argv.front());
-    }
-  };
-
   template<typename pa_type_info>
   static void InfoListCallback(pa_context *c, const pa_type_info *i, int eol, void *ud) {
     Pending *p = static_cast<Pending*>(ud);
@@ -185,6 +161,49 @@ namespace pulse {
     }
   }
 
+  static void SinkInputListCallback(pa_context *c, const pa_sink_input_info *i, int eol, void *ud) {
+    Pending *p = static_cast<Pending*>(ud);
+    Nan::HandleScope scope;
+
+    if (!p->Args()) {
+      p->Args(1);
+      p->argv[0] = Nan::Global<v8::Value>(Nan::New<v8::Array>());
+    }
+
+    if (eol) {
+      p->Return();
+      delete p;
+    } else {
+      auto info = Nan::New<v8::Object>();
+
+      Nan::Set(info, Nan::New("name").ToLocalChecked(), Nan::New(i->name != NULL ? i->name : "").ToLocalChecked());
+      Nan::Set(info, Nan::New("index").ToLocalChecked(), Nan::New(i->index));
+      Nan::Set(info, Nan::New("client").ToLocalChecked(), Nan::New(i->client));
+      Nan::Set(info, Nan::New("sink").ToLocalChecked(), Nan::New(i->sink));
+      Nan::Set(info, Nan::New("format").ToLocalChecked(), Nan::New(i->sample_spec.format));
+      Nan::Set(info, Nan::New("rate").ToLocalChecked(), Nan::New(i->sample_spec.rate));
+      Nan::Set(info, Nan::New("channels").ToLocalChecked(), Nan::New(i->sample_spec.channels));
+      Nan::Set(info, Nan::New("mute").ToLocalChecked(), Nan::New(i->mute));
+      Nan::Set(info, Nan::New("corked").ToLocalChecked(), Nan::New(bool(i->corked)));
+      Nan::Set(info, Nan::New("latency").ToLocalChecked(), Nan::New(uint32_t(i->buffer_usec + i->sink_usec)));
+      Nan::Set(info, Nan::New("driver").ToLocalChecked(), Nan::New(i->driver != NULL ? i->driver : "").ToLocalChecked());
+
+      const char *application = i->proplist ? pa_proplist_gets(i->proplist, PA_PROP_APPLICATION_NAME) : NULL;
+      const char *pid = i->proplist ? pa_proplist_gets(i->proplist, PA_PROP_APPLICATION_PROCESS_ID) : NULL;
+      Nan::Set(info, Nan::New("application").ToLocalChecked(), Nan::New(application != NULL ? application : "").ToLocalChecked());
+      Nan::Set(info, Nan::New("pid").ToLocalChecked(), Nan::New(pid != NULL ? uint32_t(strtoul(pid, NULL, 10)) : 0u));
+
+      auto volume = Nan::New<v8::Array>();
+      for (auto ch = 0; ch < i->volume.channels; ch++) {
+        Nan::Set(volume, ch, Nan::New(i->volume.values[ch]));
+      }
+      Nan::Set(info, Nan::New("volume").ToLocalChecked(), volume);
+
+      v8::Local<v8::Array> list = p->argv[0].Get(p->isolate).As<v8::Array>();
+      Nan::Set(list, list->Length(), info);
+    }
+  }
+
   void Context::info(InfoType infotype, v8::Local<v8::Function> callback) {
     Pending *p = new Pending(callback->GetIsolate(), handle(), callback);
     switch(infotype) {
@@ -200,6 +219,9 @@ namespace pulse {
     case INFO_MODULE_LIST:
       pa_context_get_module_info_list(pa_ctx, ModuleListCallback<pa_module_info>, p);
       break;
+    case INFO_SINK_INPUT_LIST:
+      pa_context_get_sink_input_info_list(pa_ctx, SinkInputListCallback, p);
+      break;
     }
   }
 
@@ -215,52 +237,206 @@ namespace pulse {
     p->Return();
   }
 
-  void Context::set_mute(InfoType infotype, uint32_t index, uint32_t mute, v8::Local<v8::Function> callback) {
-    Pending *p = new Pending(callback->GetIsolate(), handle(), callback);
-    switch(infotype) {
-    case INFO_SOURCE_LIST:
-      pa_context_set_source_mute_by_index(pa_ctx, index, mute, ContextSuccessCallback, p);
-      break;
-    case INFO_SINK_LIST:
-      pa_context_set_sink_mute_by_index(pa_ctx, index, mute, ContextSuccessCallback, p);
-      break;
+  /* Volume and mute updates are coalesced per target: at most one operation
+     is in flight for each sink, source or sink input, and requests arriving
+     meanwhile only replace the value that is sent once it completes. */
+  struct Context::VolumeUpdate {
+    Context *ctx;
+    InfoType infotype;
+    uint32_t index;
+    std::string name;
+    std::string key;
+
+    bool is_mute;
+    pa_cvolume volume;
+    int mute;
+
+    bool dirty;
+    bool sent;
+    pa_cvolume sent_volume;
+    int sent_mute;
+
+    pa_operation *op;
+    /* callbacks waiting for the latest value, and for the one in flight */
+    std::vector<std::unique_ptr<Pending>> waiting;
+    std::vector<std::unique_ptr<Pending>> flying;
+
+    VolumeUpdate(Context *ctx_, InfoType infotype_, uint32_t index_, const char *name_, bool is_mute_, const std::string& key_) :
+      ctx(ctx_), infotype(infotype_), index(index_), name(name_ ? name_ : ""), key(key_), is_mute(is_mute_), mute(0),
+      dirty(false), sent(false), sent_mute(0), op(NULL) {
+      memset(&volume, 0, sizeof(volume));
+      memset(&sent_volume, 0, sizeof(sent_volume));
+    }
+
+    ~VolumeUpdate() {
+      if (op) {
+        pa_operation_cancel(op);
+        pa_operation_unref(op);
+      }
+    }
+
+    bool changed() const {
+      if (!sent)
+        return true;
+      if (is_mute)
+        return mute != sent_mute;
+      return !pa_cvolume_equal(&volume, &sent_volume);
+    }
+  };
+
+  static void ReturnAll(std::vector<std::unique_ptr<Pending>>& list, const char *error) {
+    for (auto& p : list) {
+      p->Args(1);
+      if (error)
+        p->argv[0] = Nan::Global<v8::Value>(Nan::Error(error));
+      else
+        p->argv[0] = Nan::Global<v8::Value>(Nan::Undefined());
+      p->Return();
     }
   }
 
-  void Context::set_mute(InfoType infotype, const char* name, uint32_t mute, v8::Local<v8::Function> callback) {
-    Pending *p = new Pending(callback->GetIsolate(), handle(), callback);
-    switch(infotype) {
+  void Context::queue_update(InfoType infotype, uint32_t index, const char *name, const pa_cvolume *volume, int mute, v8::Local<v8::Function> callback) {
+    bool is_mute = volume == NULL;
+    std::string key = std::to_string(infotype) + (is_mute ? ":mute:" : ":volume:") +
+      (name ? std::string("@") + name : std::to_string(index));
+
+    auto& update = volume_updates[key];
+    if (!update)
+      update.reset(new VolumeUpdate(this, infotype, index, name, is_mute, key));
+
+    if (is_mute)
+      update->mute = mute;
+    else
+      update->volume = *volume;
+    update->dirty = true;
+    update->waiting.emplace_back(new Pending(callback->GetIsolate(), handle(), callback));
+
+    LOG("volume update %s%s", key.c_str(), update->op ? " (coalesced)" : "");
+
+    if (!update->op)
+      send_update(update.get());
+  }
+
+  void Context::send_update(VolumeUpdate *u) {
+    u->dirty = false;
+    u->flying = std::move(u->waiting);
+    u->waiting.clear();
+
+    bool by_name = !u->name.empty();
+    const char *name = u->name.c_str();
+
+    switch(u->infotype) {
     case INFO_SOURCE_LIST:
-      pa_context_set_source_mute_by_name(pa_ctx, name, mute, ContextSuccessCallback, p);
+      if (u->is_mute)
+        u->op = by_name ? pa_context_set_source_mute_by_name(pa_ctx, name, u->mute, VolumeUpdateCallback, u) :
+          pa_context_set_source_mute_by_index(pa_ctx, u->index, u->mute, VolumeUpdateCallback, u);
+      else
+        u->op = by_name ? pa_context_set_source_volume_by_name(pa_ctx, name, &u->volume, VolumeUpdateCallback, u) :
+          pa_context_set_source_volume_by_index(pa_ctx, u->index, &u->volume, VolumeUpdateCallback, u);
       break;
     case INFO_SINK_LIST:
-      pa_context_set_sink_mute_by_name(pa_ctx, name, mute, ContextSuccessCallback, p);
+      if (u->is_mute)
+        u->op = by_name ? pa_context_set_sink_mute_by_name(pa_ctx, name, u->mute, VolumeUpdateCallback, u) :
+          pa_context_set_sink_mute_by_index(pa_ctx, u->index, u->mute, VolumeUpdateCallback, u);
+      else
+        u->op = by_name ? pa_context_set_sink_volume_by_name(pa_ctx, name, &u->volume, VolumeUpdateCallback, u) :
+          pa_context_set_sink_volume_by_index(pa_ctx, u->index, &u->volume, VolumeUpdateCallback, u);
       break;
+    case INFO_SINK_INPUT_LIST:
+      if (u->is_mute)
+        u->op = pa_context_set_sink_input_mute(pa_ctx, u->index, u->mute, VolumeUpdateCallback, u);
+      else
+        u->op = pa_context_set_sink_input_volume(pa_ctx, u->index, &u->volume, VolumeUpdateCallback, u);
+      break;
+    default:
+      break;
+    }
+
+    u->sent = true;
+    u->sent_mute = u->mute;
+    u->sent_volume = u->volume;
+
+    if (!u->op) {
+      /* the request could not be issued, do not leave the callers hanging */
+      auto flying = std::move(u->flying);
+      std::string key = u->key;
+      volume_updates.erase(key);
+      ReturnAll(flying, pa_strerror(pa_context_errno(pa_ctx)));
     }
   }
 
-  void Context::set_volume(InfoType infotype, uint32_t index, const pa_cvolume *volume, v8::Local<v8::Function> callback) {
-    Pending *p = new Pending(callback->GetIsolate(), handle(), callback);
-    switch(infotype) {
-    case INFO_SOURCE_LIST:
-      pa_context_set_source_volume_by_index(pa_ctx, index, volume, ContextSuccessCallback, p);
-      break;
-    case INFO_SINK_LIST:
-      pa_context_set_sink_volume_by_index(pa_ctx, index, volume, ContextSuccessCallback, p);
-      break;
+  void Context::VolumeUpdateCallback(pa_context *c, int success, void *ud) {
+    VolumeUpdate *u = static_cast<VolumeUpdate*>(ud);
+    Context *ctx = u->ctx;
+    Nan::HandleScope scope;
+
+    pa_operation_unref(u->op);
+    u->op = NULL;
+
+    auto done = std::move(u->flying);
+    u->flying.clear();
+    /* callers merged into the failed update fail with it */
+    const char *error = success ? NULL : pa_strerror(pa_context_errno(c));
+
+    if (u->dirty && u->changed()) {
+      ctx->send_update(u);
+    } else {
+      for (auto& p : u->waiting)
+        done.emplace_back(std::move(p));
+      std::string key = u->key;
+      ctx->volume_updates.erase(key);
     }
+
+    ReturnAll(done, error);
+  }
+
+  void Context::set_mute(InfoType infotype, uint32_t index, uint32_t mute, v8::Local<v8::Function> callback) {
+    queue_update(infotype, index, NULL, NULL, mute, callback);
+  }
+
+  void Context::set_mute(InfoType infotype, const char* name, uint32_t mute, v8::Local<v8::Function> callback) {
+    queue_update(infotype, PA_INVALID_INDEX, name, NULL, mute, callback);
+  }
+
+  void Context::set_volume(InfoType infotype, uint32_t index, const pa_cvolume *volume, v8::Local<v8::Function> callback) {
+    queue_update(infotype, index, NULL, volume, 0, callback);
   }
 
   void Context::set_volume(InfoType infotype, const char* name, const pa_cvolume *volume, v8::Local<v8::Function> callback) {
+    queue_update(infotype, PA_INVALID_INDEX, name, volume, 0, callback);
+  }
+
+  void Context::MoveCallback(pa_context *c, int success, void *ud) {
+    Pending *p = static_cast<Pending*>(ud);
+    Nan::HandleScope scope;
+
+    p->Args(1);
+    if (success)
+      p->argv[0] = Nan::Global<v8::Value>(Nan::Undefined());
+    else
+      p->argv[0] = Nan::Global<v8::Value>(Nan::Error(pa_strerror(pa_context_errno(c))));
+
+    p->Return();
+    delete p;
+  }
+
+  void Context::move(pa_stream_direction_t direction, uint32_t index, uint32_t device, const char* device_name, v8::Local<v8::Function> callback) {
     Pending *p = new Pending(callback->GetIsolate(), handle(), callback);
-    switch(infotype) {
-    case INFO_SOURCE_LIST:
-      pa_context_set_source_volume_by_name(pa_ctx, name, volume, ContextSuccessCallback, p);
-      break;
-    case INFO_SINK_LIST:
-      pa_context_set_sink_volume_by_name(pa_ctx, name, volume, ContextSuccessCallback, p);
-      break;
+    pa_operation *op;
+
+    if (direction == PA_STREAM_PLAYBACK)
+      op = device_name ? pa_context_move_sink_input_by_name(pa_ctx, index, device_name, MoveCallback, p)
+                       : pa_context_move_sink_input_by_index(pa_ctx, index, device, MoveCallback, p);
+    else
+      op = device_name ? pa_context_move_source_output_by_name(pa_ctx, index, device_name, MoveCallback, p)
+                       : pa_context_move_source_output_by_index(pa_ctx, index, device, MoveCallback, p);
+
+    if (!op) {
+      /* the request could not be issued, do not leave the caller hanging */
+      MoveCallback(pa_ctx, 0, p);
+      return;
     }
+    pa_operation_unref(op);
   }
 
   static void ContextIndexCallback(pa_context *c, unsigned int index, void *ud) {
@@ -285,6 +461,15 @@ namespace pulse {
     pa_context_unload_module(pa_ctx, index, ContextSuccessCallback, p);
   }
 
+  /* memory */
+
+  void Context::account(int64_t native_delta, int64_t queued_delta) {
+    memory += native_delta;
+    queued += queued_delta;
+    if (native_delta)
+      Nan::AdjustExternalMemory(int(native_delta));
+  }
+
   /* bindings */
 
   void
@@ -301,8 +486,12 @@ namespace pulse {
     Nan::SetPrototypeMethod(tpl, "info", Info);
     Nan::SetPrototypeMethod(tpl, "set_volume", SetVolume);
     Nan::SetPrototypeMethod(tpl, "set_mute", SetMute);
+    Nan::SetPrototypeMethod(tpl, "move", Move);
+    Nan::SetPrototypeMethod(tpl, "batch", RunBatch);
     Nan::SetPrototypeMethod(tpl, "load_module", LoadModule);
     Nan::SetPrototypeMethod(tpl, "unload_module", UnloadModule);
+    Nan::SetPrototypeMethod(tpl, "memory", Memory);
+    Nan::SetPrototypeMethod(tpl, "set_memory_budget", SetMemoryBudget);
 
     auto cfn = Nan::GetFunction(tpl).ToLocalChecked();
     Nan::Set(target, Nan::New("Context").ToLocalChecked(), cfn);
@@ -312,6 +501,14 @@ namespace pulse {
     DefineConstant(flags, noautospawn, PA_CONTEXT_NOAUTOSPAWN);
     DefineConstant(flags, nofail, PA_CONTEXT_NOFAIL);
 
+    AddEmptyObject(cfn, batch);
+    DefineConstant(batch, load_module, BATCH_LOAD_MODULE);
+    DefineConstant(batch, unload_module, BATCH_UNLOAD_MODULE);
+    DefineConstant(batch, set_volume, BATCH_SET_VOLUME);
+    DefineConstant(batch, set_mute, BATCH_SET_MUTE);
+    DefineConstant(batch, move_sink_input, BATCH_MOVE_SINK_INPUT);
+    DefineConstant(batch, move_source_output, BATCH_MOVE_SOURCE_OUTPUT);
+
     AddEmptyObject(cfn, state);
     DefineConstant(state, unconnected, PA_CONTEXT_UNCONNECTED);
     DefineConstant(state, connecting, PA_CONTEXT_CONNECTING);
@@ -326,6 +523,7 @@ namespace pulse {
     DefineConstant(info, source_list, INFO_SOURCE_LIST);
     DefineConstant(info, sink_list, INFO_SINK_LIST);
     DefineConstant(info, module_list, INFO_MODULE_LIST);
+    DefineConstant(info, sink_input_list, INFO_SINK_INPUT_LIST);
   }
 
   void
@@ -418,6 +616,9 @@ namespace pulse {
     Context *ctx = ObjectWrap::Unwrap<Context>(args.This());
     JS_ASSERT(ctx);
 
+    if (Nan::To<uint32_t>(args[0]).FromJust() == INFO_SINK_INPUT_LIST)
+      JS_ASSERT(args[1]->IsUint32());
+
     if (args[1]->IsUint32())
         ctx->set_mute(InfoType(Nan::To<uint32_t>(args[0]).FromJust()), Nan::To<uint32_t>(args[1]).FromJust(), Nan::To<uint32_t>(args[2]).FromJust(), args[3].As<v8::Function>());
     else
@@ -441,6 +642,9 @@ namespace pulse {
     Context *ctx = ObjectWrap::Unwrap<Context>(args.This());
     JS_ASSERT(ctx);
 
+    if (Nan::To<uint32_t>(args[0]).FromJust() == INFO_SINK_INPUT_LIST)
+      JS_ASSERT(args[1]->IsUint32());
+
     pa_cvolume cvolume;
     memset(&cvolume, 0, sizeof(cvolume));
     cvolume.channels = std::min(volume->Length(), PA_CHANNELS_MAX);
@@ -455,6 +659,114 @@ namespace pulse {
     args.GetReturnValue().SetUndefined();
   }
 
+  void
+  Context::Move(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    JS_ASSERT(args.Length() == 4);
+    JS_ASSERT(args[0]->IsUint32());
+    JS_ASSERT(args[1]->IsUint32());
+    JS_ASSERT(args[2]->IsUint32() || args[2]->IsString());
+    JS_ASSERT(args[3]->IsFunction());
+
+    Context *ctx = ObjectWrap::Unwrap<Context>(args.This());
+    JS_ASSERT(ctx);
+
+    pa_stream_direction_t direction = pa_stream_direction_t(Nan::To<uint32_t>(args[0]).FromJust());
+    JS_ASSERT(direction == PA_STREAM_PLAYBACK || direction == PA_STREAM_RECORD);
+
+    if (args[2]->IsUint32())
+      ctx->move(direction, Nan::To<uint32_t>(args[1]).FromJust(), Nan::To<uint32_t>(args[2]).FromJust(), NULL, args[3].As<v8::Function>());
+    else
+      ctx->move(direction, Nan::To<uint32_t>(args[1]).FromJust(), PA_INVALID_INDEX, *Nan::Utf8String(args[2]), args[3].As<v8::Function>());
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  /* steps are [op, target, index or name, value], as built by the JS layer */
+  void
+  Context::RunBatch(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    JS_ASSERT(args.Length() == 3);
+    JS_ASSERT(args[0]->IsArray());
+    JS_ASSERT(args[2]->IsFunction());
+
+    Context *ctx = ObjectWrap::Unwrap<Context>(args.This());
+    JS_ASSERT(ctx);
+
+    auto list = args[0].As<v8::Array>();
+    std::vector<Batch::Step> steps;
+    steps.reserve(list->Length());
+
+    for (uint32_t i = 0; i < list->Length(); i++) {
+      auto item = Nan::Get(list, i).ToLocalChecked();
+      JS_ASSERT(item->IsArray());
+      auto arr = item.As<v8::Array>();
+      JS_ASSERT(arr->Length() == 4);
+
+      auto op = Nan::Get(arr, 0).ToLocalChecked();
+      auto target = Nan::Get(arr, 1).ToLocalChecked();
+      auto subject = Nan::Get(arr, 2).ToLocalChecked();
+      auto value = Nan::Get(arr, 3).ToLocalChecked();
+      JS_ASSERT(op->IsUint32() && Nan::To<uint32_t>(op).FromJust() <= BATCH_MOVE_SOURCE_OUTPUT);
+      JS_ASSERT(subject->IsUint32() || subject->IsString());
+
+      Batch::Step step(BatchOp(Nan::To<uint32_t>(op).FromJust()));
+      if (subject->IsUint32())
+        step.index = Nan::To<uint32_t>(subject).FromJust();
+      else
+        step.name = *Nan::Utf8String(subject);
+
+      switch(step.op) {
+      case BATCH_LOAD_MODULE:
+        JS_ASSERT(subject->IsString() && value->IsString());
+        step.argument = *Nan::Utf8String(value);
+        break;
+      case BATCH_UNLOAD_MODULE:
+        JS_ASSERT(subject->IsUint32());
+        break;
+      case BATCH_SET_VOLUME:
+      case BATCH_SET_MUTE: {
+        JS_ASSERT(target->IsUint32());
+        step.target = InfoType(Nan::To<uint32_t>(target).FromJust());
+        JS_ASSERT(step.target == INFO_SINK_LIST || step.target == INFO_SOURCE_LIST || step.target == INFO_SINK_INPUT_LIST);
+        if (step.target == INFO_SINK_INPUT_LIST)
+          JS_ASSERT(subject->IsUint32());
+
+        if (step.op == BATCH_SET_MUTE) {
+          JS_ASSERT(value->IsUint32());
+          step.mute = Nan::To<uint32_t>(value).FromJust();
+          break;
+        }
+
+        JS_ASSERT(value->IsArray());
+        auto volume = value.As<v8::Array>();
+        step.volume.channels = std::min(volume->Length(), PA_CHANNELS_MAX);
+        for (uint32_t j = 0; j < step.volume.channels; j++) {
+          auto v = Nan::Get(volume, j).ToLocalChecked();
+          JS_ASSERT(v->IsUint32());
+          step.volume.values[j] = Nan::To<uint32_t>(v).FromJust();
+        }
+        break;
+      }
+      case BATCH_MOVE_SINK_INPUT:
+      case BATCH_MOVE_SOURCE_OUTPUT:
+        JS_ASSERT(subject->IsUint32());
+        JS_ASSERT(value->IsUint32() || value->IsString());
+        if (value->IsUint32())
+          step.device = Nan::To<uint32_t>(value).FromJust();
+        else
+          step.name = *Nan::Utf8String(value);
+        break;
+      }
+
+      steps.push_back(std::move(step));
+    }
+
+    Pending *p = new Pending(args.GetIsolate(), ctx->handle(), args[2].As<v8::Function>());
+    Batch *batch = new Batch(ctx->pa_ctx, std::move(steps), Nan::To<bool>(args[1]).FromJust(), p);
+    batch->run();
+
+    args.GetReturnValue().SetUndefined();
+  }
+
   void
   Context::LoadModule(const Nan::FunctionCallbackInfo<v8::Value>& args) {
     JS_ASSERT(args.Length() == 3);
@@ -483,5 +795,30 @@ namespace pulse {
 
     args.GetReturnValue().SetUndefined();
   }
-}
 
+  void
+  Context::Memory(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Context *ctx = ObjectWrap::Unwrap<Context>(args.This());
+    JS_ASSERT(ctx);
+
+    auto info = Nan::New<v8::Object>();
+    Nan::Set(info, Nan::New("native").ToLocalChecked(), Nan::New(double(ctx->memory)));
+    Nan::Set(info, Nan::New("queued").ToLocalChecked(), Nan::New(double(ctx->queued)));
+    Nan::Set(info, Nan::New("budget").ToLocalChecked(), Nan::New(double(ctx->memory_budget)));
+
+    args.GetReturnValue().Set(info);
+  }
+
+  void
+  Context::SetMemoryBudget(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    JS_ASSERT(args.Length() == 1);
+    JS_ASSERT(args[0]->IsNumber());
+
+    Context *ctx = ObjectWrap::Unwrap<Context>(args.This());
+    JS_ASSERT(ctx);
+
+    ctx->memory_budget = int64_t(Nan::To<double>(args[0]).FromJust());
+
+    args.GetReturnValue().SetUndefined();
+  }
+}
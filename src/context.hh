@@ -22,12 +22,16 @@
 
 #include "common.hh"
 
+#include <map>
+#include <string>
+
 namespace pulse {
   enum InfoType {
     INFO_SERVER,
     INFO_SOURCE_LIST,
     INFO_SINK_LIST,
-    INFO_MODULE_LIST
+    INFO_MODULE_LIST,
+    INFO_SINK_INPUT_LIST
   };
   
   class Context: public Nan::ObjectWrap {
@@ -55,11 +59,33 @@ namespace pulse {
     void info(InfoType infotype, v8::Local<v8::Function> callback);
 
     /* volume control */
+    struct VolumeUpdate;
+    std::map<std::string, std::unique_ptr<VolumeUpdate>> volume_updates;
+    static void VolumeUpdateCallback(pa_context *c, int success, void *ud);
+    void queue_update(InfoType infotype, uint32_t index, const char* name, const pa_cvolume* volume, int mute, v8::Local<v8::Function> callback);
+    void send_update(VolumeUpdate *update);
+
     void set_mute(InfoType infotype, uint32_t index, uint32_t mute, v8::Local<v8::Function> callback);
     void set_mute(InfoType infotype, const char* name, uint32_t mute, v8::Local<v8::Function> callback);
     void set_volume(InfoType infotype, uint32_t index, const pa_cvolume* volume, v8::Local<v8::Function> callback);
     void set_volume(InfoType infotype, const char* name, const pa_cvolume* volume, v8::Local<v8::Function> callback);
 
+    /* native memory held by the streams of this context: allocations,
+       reported to V8, and JS buffers queued natively; writes and queues
+       give up past the budget, when there is one */
+    int64_t memory;
+    int64_t queued;
+    int64_t memory_budget;
+
+    void account(int64_t native_delta, int64_t queued_delta);
+    bool over_budget(size_t more) const {
+      return memory_budget > 0 && memory + queued + int64_t(more) > memory_budget;
+    }
+
+    /* moving sink inputs and source outputs, by device index or name */
+    static void MoveCallback(pa_context *c, int success, void *ud);
+    void move(pa_stream_direction_t direction, uint32_t index, uint32_t device, const char* device_name, v8::Local<v8::Function> callback);
+
     /* module */
     void load_module(const char* name, const char* argument, v8::Local<v8::Function> callback);
     void unload_module(uint32_t index, v8::Local<v8::Function> callback);
@@ -79,8 +105,14 @@ namespace pulse {
     static void SetVolume(const Nan::FunctionCallbackInfo<v8::Value>& info);
     static void SetMute(const Nan::FunctionCallbackInfo<v8::Value>& info);
 
+    static void Move(const Nan::FunctionCallbackInfo<v8::Value>& info);
+    static void RunBatch(const Nan::FunctionCallbackInfo<v8::Value>& info);
+
     static void LoadModule(const Nan::FunctionCallbackInfo<v8::Value>& info);
     static void UnloadModule(const Nan::FunctionCallbackInfo<v8::Value>& info);
+
+    static void Memory(const Nan::FunctionCallbackInfo<v8::Value>& info);
+    static void SetMemoryBudget(const Nan::FunctionCallbackInfo<v8::Value>& info);
   };
 }
 
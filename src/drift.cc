@@ -0,0 +1,55 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "drift.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pulse {
+  static const double smoothing = 0.02;         /* per measurement */
+  static const double settle_usec = 2000000;    /* before learning the setpoint */
+  static const double step_usec = 1000000;      /* between controller steps */
+  static const double kp = 0.1;                 /* ppm per usec of error, per second */
+  static const double ki = 0.005;
+
+  Drift::Drift(uint32_t rate, pa_usec_t setpoint_, double max_ppm_, double now) :
+    nominal(rate), setpoint(double(setpoint_)), max_ppm(max_ppm_),
+    fill(-1), integral(0), correction(0), started(now), last_step(now) {}
+
+  uint32_t Drift::update(double now, double level) {
+    fill = fill < 0 ? level : fill + smoothing * (level - fill);
+
+    if (now - started < settle_usec || now - last_step < step_usec)
+      return uint32_t(std::lround(nominal * (1.0 + correction / 1e6)));
+
+    if (setpoint <= 0)
+      setpoint = fill;
+
+    /* a queue above the setpoint means the capture clock runs faster:
+       declare a higher rate so the server consumes our samples faster */
+    double dt = (now - last_step) / 1e6;
+    double error = fill - setpoint;
+    last_step = now;
+
+    integral = std::min(std::max(integral + ki * error * dt, -max_ppm), max_ppm);
+    correction = std::min(std::max(kp * error + integral, -max_ppm), max_ppm);
+
+    return uint32_t(std::lround(nominal * (1.0 + correction / 1e6)));
+  }
+}
@@ -0,0 +1,54 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __DRIFT_HH__
+#define __DRIFT_HH__
+
+#include "common.hh"
+
+namespace pulse {
+  /* Estimates the clock drift between a capture and a playback device
+     from the fill level of the playback queue, and corrects it with the
+     playback sample rate: a PI controller steers the smoothed fill level
+     to the setpoint, within max_ppm of the nominal rate. Without a
+     setpoint, the level reached once the link has settled is kept. */
+  class Drift {
+  private:
+    double nominal;
+    double setpoint;   /* usec */
+    double max_ppm;
+
+    double fill;       /* smoothed queue level, usec */
+    double integral;   /* ppm */
+    double correction; /* ppm */
+    double started;
+    double last_step;
+
+  public:
+    Drift(uint32_t rate, pa_usec_t setpoint, double max_ppm, double now);
+
+    /* feed a measurement of the queue level, returns the rate to play at */
+    uint32_t update(double now, double level);
+
+    double ppm() const {
+      return correction;
+    }
+  };
+}
+
+#endif//__DRIFT_HH__
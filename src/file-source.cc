@@ -0,0 +1,219 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "file-source.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pulse {
+  static uint16_t le16(const char *p) {
+    const unsigned char *u = reinterpret_cast<const unsigned char*>(p);
+    return uint16_t(u[0] | (u[1] << 8));
+  }
+
+  static uint32_t le32(const char *p) {
+    const unsigned char *u = reinterpret_cast<const unsigned char*>(p);
+    return uint32_t(u[0]) | (uint32_t(u[1]) << 8) | (uint32_t(u[2]) << 16) | (uint32_t(u[3]) << 24);
+  }
+
+  enum {
+    WAVE_FORMAT_PCM = 0x0001,
+    WAVE_FORMAT_IEEE_FLOAT = 0x0003,
+    WAVE_FORMAT_ALAW = 0x0006,
+    WAVE_FORMAT_MULAW = 0x0007,
+    WAVE_FORMAT_EXTENSIBLE = 0xFFFE,
+  };
+
+  static pa_sample_format_t wav_format(unsigned tag, unsigned bits, unsigned container) {
+    switch (tag) {
+    case WAVE_FORMAT_PCM:
+      switch (container) {
+      case 8: return PA_SAMPLE_U8;
+      case 16: return PA_SAMPLE_S16LE;
+      case 24: return PA_SAMPLE_S24LE;
+      case 32: return bits == 24 ? PA_SAMPLE_S24_32LE : PA_SAMPLE_S32LE;
+      }
+      break;
+    case WAVE_FORMAT_IEEE_FLOAT:
+      if (container == 32)
+        return PA_SAMPLE_FLOAT32LE;
+      break;
+    case WAVE_FORMAT_ALAW:
+      if (container == 8)
+        return PA_SAMPLE_ALAW;
+      break;
+    case WAVE_FORMAT_MULAW:
+      if (container == 8)
+        return PA_SAMPLE_ULAW;
+      break;
+    }
+    return PA_SAMPLE_INVALID;
+  }
+
+  FileSource::FileSource() : mapping(NULL), data(NULL), length(0), position(0), loop(false) {
+    ss.format = PA_SAMPLE_INVALID;
+    ss.rate = 0;
+    ss.channels = 0;
+  }
+
+  FileSource::~FileSource() {
+    if (mapping)
+      Unref(mapping);
+  }
+
+  const char *FileSource::parse_wav(const char *base, size_t size) {
+    const char *p = base + 12, *end = base + size;
+    bool have_fmt = false;
+
+    while (end - p >= 8) {
+      uint32_t chunk_size = le32(p + 4);
+      const char *chunk = p + 8;
+      size_t avail = end - chunk;
+
+      if (!memcmp(p, "fmt ", 4)) {
+        if (chunk_size < 16 || avail < 16)
+          return "Truncated WAV format chunk.";
+
+        unsigned tag = le16(chunk);
+        unsigned channels = le16(chunk + 2);
+        unsigned block_align = le16(chunk + 12);
+        unsigned bits = le16(chunk + 14);
+
+        if (tag == WAVE_FORMAT_EXTENSIBLE) {
+          if (chunk_size < 40 || avail < 40)
+            return "Truncated WAV format chunk.";
+          /* the sub-format GUID starts with the actual format tag */
+          tag = le16(chunk + 24);
+        }
+
+        ss.format = wav_format(tag, bits, channels ? block_align * 8 / channels : 0);
+        ss.rate = le32(chunk + 4);
+        ss.channels = uint8_t(std::min(channels, 255u));
+        if (!pa_sample_spec_valid(&ss) || channels > PA_CHANNELS_MAX)
+          return "Unsupported WAV sample format.";
+        have_fmt = true;
+      } else if (!memcmp(p, "data", 4)) {
+        if (!have_fmt)
+          return "WAV data before the format chunk.";
+        /* files written by streaming encoders may not have a final size */
+        data = chunk;
+        length = std::min<size_t>(chunk_size, avail);
+        return NULL;
+      }
+
+      if (chunk_size >= avail)
+        break;
+      p = chunk + chunk_size + (chunk_size & 1);
+    }
+
+    return "No audio data in WAV file.";
+  }
+
+  const char *FileSource::open(const char *path, const pa_sample_spec& raw_ss) {
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return strerror(errno);
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+      int err = errno;
+      ::close(fd);
+      return strerror(err);
+    }
+    if (!S_ISREG(st.st_mode) || st.st_size <= 0) {
+      ::close(fd);
+      return "Not a regular, non-empty file.";
+    }
+
+    size_t size = size_t(st.st_size);
+    void *base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+      return strerror(errno);
+    madvise(base, size, MADV_SEQUENTIAL);
+
+    if (mapping)
+      Unref(mapping);
+    mapping = new Mapping();
+    mapping->base = base;
+    mapping->size = size;
+    mapping->refs = 1;
+    position = 0;
+
+    const char *b = static_cast<const char*>(base);
+    if (size >= 12 && !memcmp(b, "RIFF", 4) && !memcmp(b + 8, "WAVE", 4)) {
+      const char *err = parse_wav(b, size);
+      if (err)
+        return err;
+    } else {
+      ss = raw_ss;
+      data = b;
+      length = size;
+    }
+
+    length -= length % pa_frame_size(&ss);
+    if (!length)
+      return "No audio data in file.";
+
+    return NULL;
+  }
+
+  void FileSource::seek(size_t frame) {
+    position = std::min(frame * pa_frame_size(&ss), length);
+  }
+
+  const char *FileSource::next(size_t *size) {
+    if (position >= length) {
+      if (!loop)
+        return NULL;
+      position = 0;
+    }
+
+    /* whole frames only, the stream must not get out of alignment */
+    size_t chunk = std::min(*size, length - position);
+    chunk -= chunk % pa_frame_size(&ss);
+    if (!chunk)
+      chunk = std::min(pa_frame_size(&ss), length - position);
+
+    const char *p = data + position;
+    position += chunk;
+    *size = chunk;
+    return p;
+  }
+
+  void *FileSource::ref() {
+    mapping->refs++;
+    return mapping;
+  }
+
+  void FileSource::Unref(void *ud) {
+    Mapping *m = static_cast<Mapping*>(ud);
+
+    if (--m->refs == 0) {
+      munmap(m->base, m->size);
+      delete m;
+    }
+  }
+}
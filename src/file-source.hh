@@ -0,0 +1,82 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __FILE_SOURCE_HH__
+#define __FILE_SOURCE_HH__
+
+#include "common.hh"
+
+#include <algorithm>
+#include <atomic>
+
+namespace pulse {
+  /* Audio file played straight from a read-only memory mapping. WAV files
+     carry their own sample spec; anything else is taken as raw PCM in the
+     spec given when opening. Chunks are handed to libpulse without a copy,
+     each holding a reference on the mapping, so the file stays mapped for
+     as long as the server side may still read from it. */
+  class FileSource {
+  private:
+    struct Mapping {
+      void *base;
+      size_t size;
+      std::atomic<unsigned> refs;
+    };
+
+    Mapping *mapping;
+    const char *data;
+    size_t length;      /* bytes of audio, whole frames */
+    size_t position;    /* bytes */
+
+    const char *parse_wav(const char *base, size_t size);
+
+  public:
+    pa_sample_spec ss;
+    bool loop;
+
+    FileSource();
+    ~FileSource();
+
+    FileSource(const FileSource&) = delete;
+    FileSource& operator=(const FileSource&) = delete;
+
+    /* returns an error message, or NULL on success */
+    const char *open(const char *path, const pa_sample_spec& raw_ss);
+
+    size_t frames() const {
+      return length / pa_frame_size(&ss);
+    }
+
+    void seek(size_t frame);
+
+    /* give back the tail of the last chunk, which could not be written */
+    void unread(size_t size) {
+      position -= std::min(size, position);
+    }
+
+    /* next chunk of at most *size bytes, which is updated, or NULL at the
+       end of a file that does not loop */
+    const char *next(size_t *size);
+
+    /* references on the mapping, for pa_stream_write_ext_free */
+    void *ref();
+    static void Unref(void *mapping);
+  };
+}
+
+#endif//__FILE_SOURCE_HH__
@@ -0,0 +1,132 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gain.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pulse {
+  /* exponential ramps cannot reach zero, they go through -80dB instead */
+  static const float exp_floor = 1e-4f;
+
+  Gain::Gain() : position(0), current(1.0f), ramping(false), curve(GAIN_LINEAR), target(1.0f), step(0.0f), remaining(0) {}
+
+  void Gain::schedule(float target, uint64_t frames, GainCurve curve, uint64_t delay) {
+    Segment segment = { position + delay, target, frames, curve };
+
+    /* a new event replaces everything scheduled at or after it */
+    while (!segments.empty() && segments.back().start >= segment.start)
+      segments.pop_back();
+    segments.push_back(segment);
+  }
+
+  void Gain::cancel() {
+    segments.clear();
+    ramping = false;
+  }
+
+  void Gain::begin(const Segment& segment) {
+    target = segment.target;
+    curve = segment.curve;
+    remaining = segment.frames;
+
+    if (!remaining) {
+      current = target;
+      ramping = false;
+      return;
+    }
+
+    ramping = true;
+    if (curve == GAIN_EXPONENTIAL) {
+      float from = std::max(current, exp_floor);
+      float to = std::max(target, exp_floor);
+      current = from;
+      step = std::pow(to / from, 1.0f / float(remaining));
+    } else {
+      step = (target - current) / float(remaining);
+    }
+  }
+
+  void Gain::apply(float *data, size_t frames, unsigned channels) {
+    if (current == 1.0f)
+      return;
+
+    const float g = current;
+    const size_t samples = frames * channels;
+    for (size_t i = 0; i < samples; i++)
+      data[i] *= g;
+  }
+
+  void Gain::ramp(float *data, size_t frames, unsigned channels) {
+    float g = current;
+
+    if (curve == GAIN_EXPONENTIAL) {
+      for (size_t f = 0; f < frames; f++, data += channels) {
+        g *= step;
+        for (unsigned c = 0; c < channels; c++)
+          data[c] *= g;
+      }
+    } else {
+      for (size_t f = 0; f < frames; f++, data += channels) {
+        g += step;
+        for (unsigned c = 0; c < channels; c++)
+          data[c] *= g;
+      }
+    }
+
+    current = g;
+    remaining -= frames;
+    if (!remaining) {
+      /* land exactly on the target, whatever the rounding */
+      current = target;
+      ramping = false;
+    }
+  }
+
+  void Gain::process(float *data, size_t frames, unsigned channels) {
+    while (frames > 0) {
+      if (!ramping && !segments.empty() && segments.front().start <= position) {
+        begin(segments.front());
+        segments.pop_front();
+        continue;
+      }
+
+      if (ramping && !segments.empty() && segments.front().start <= position) {
+        /* the next event interrupts the current ramp where it is */
+        ramping = false;
+        continue;
+      }
+
+      size_t chunk = frames;
+      if (ramping && remaining < chunk)
+        chunk = size_t(remaining);
+      if (!segments.empty() && segments.front().start - position < chunk)
+        chunk = size_t(segments.front().start - position);
+
+      if (ramping)
+        ramp(data, chunk, channels);
+      else
+        apply(data, chunk, channels);
+
+      data += chunk * channels;
+      frames -= chunk;
+      position += chunk;
+    }
+  }
+}
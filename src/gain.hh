@@ -0,0 +1,76 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __GAIN_HH__
+#define __GAIN_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace pulse {
+  enum GainCurve {
+    GAIN_LINEAR,
+    GAIN_EXPONENTIAL
+  };
+
+  /* Sample-accurate gain automation. Positions are counted in frames
+     processed by the stage, so a ramp scheduled with a delay of N frames
+     starts exactly N frames after the next frame written or read. */
+  class Gain {
+  private:
+    struct Segment {
+      uint64_t start;
+      float target;
+      uint64_t frames;
+      GainCurve curve;
+    };
+
+    uint64_t position;
+    float current;
+    std::deque<Segment> segments;
+
+    /* ramp in progress */
+    bool ramping;
+    GainCurve curve;
+    float target;
+    float step;
+    uint64_t remaining;
+
+    void begin(const Segment& segment);
+    void apply(float *data, size_t frames, unsigned channels);
+    void ramp(float *data, size_t frames, unsigned channels);
+
+  public:
+    Gain();
+
+    void schedule(float target, uint64_t frames, GainCurve curve, uint64_t delay);
+    void cancel();
+
+    bool active() const {
+      return ramping || current != 1.0f || !segments.empty();
+    }
+    float value() const {
+      return current;
+    }
+
+    void process(float *data, size_t frames, unsigned channels);
+  };
+}
+
+#endif//__GAIN_HH__
@@ -0,0 +1,197 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "jitter.hh"
+#include "sample.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace pulse {
+  JitterBuffer::JitterBuffer(const pa_sample_spec& ss_, pa_usec_t min_depth_, pa_usec_t max_depth_) :
+    ss(ss_), stored(0), last_ts(0), last_raw(0), have_ts(false), playing(false), buffering(false), next(0),
+    jitter(0), last_transit(0), have_transit(false), packet_frames(0), concealed(0),
+    received(0), late(0), lost(0), skipped(0), refused(0) {
+    frame_size = pa_frame_size(&ss);
+    min_depth = pa_usec_to_bytes(min_depth_, &ss) / frame_size;
+    max_depth = std::max(min_depth, pa_usec_to_bytes(max_depth_, &ss) / frame_size);
+  }
+
+  int64_t JitterBuffer::end() const {
+    if (packets.empty())
+      return next;
+    auto it = packets.rbegin();
+    return it->first + int64_t(it->second.size() / frame_size);
+  }
+
+  size_t JitterBuffer::depth() const {
+    if (packets.empty())
+      return 0;
+    int64_t start = playing ? next : packets.begin()->first;
+    return size_t(std::max<int64_t>(end() - start, 0));
+  }
+
+  size_t JitterBuffer::target() const {
+    size_t t = packet_frames + size_t(4 * jitter);
+    return std::min(std::max(t, min_depth), max_depth);
+  }
+
+  void JitterBuffer::push(uint32_t timestamp, const char *data, size_t size, double arrival_usec) {
+    size_t frames = size / frame_size;
+    if (!frames)
+      return;
+
+    /* unwrap against the newest timestamp seen, reordered packets come out behind it */
+    int64_t ts = have_ts ? last_ts + int32_t(timestamp - last_raw) : int64_t(timestamp);
+    if (!have_ts || ts > last_ts) {
+      last_ts = ts;
+      last_raw = timestamp;
+    }
+    have_ts = true;
+    received++;
+    packet_frames = frames;
+
+    double transit = arrival_usec * ss.rate / 1e6 - double(ts);
+    if (have_transit)
+      jitter += (std::fabs(transit - last_transit) - jitter) / 16;
+    last_transit = transit;
+    have_transit = true;
+
+    if (playing && ts + int64_t(frames) <= next) {
+      late++;
+      return;
+    }
+
+    std::vector<char>& packet = packets[ts];
+    stored -= packet.size();
+    packet.assign(data, data + frames * frame_size);
+    stored += packet.size();
+  }
+
+  void JitterBuffer::conceal(char *dst, size_t frames) {
+    size_t last_frames = last.size() / frame_size;
+    if (!last_frames || !sample_format_supported(ss.format)) {
+      pa_silence_memory(dst, frames * frame_size, &ss);
+      concealed += frames;
+      return;
+    }
+
+    /* replay the last packet, halving its level with every repetition */
+    size_t ch = ss.channels;
+    scratch.resize((last_frames + frames) * ch);
+    float *src = scratch.data();
+    float *out = src + last_frames * ch;
+
+    samples_to_float(ss.format, last.data(), src, last_frames * ch);
+    for (size_t i = 0; i < frames; i++) {
+      size_t pos = concealed + i;
+      float g = float(std::exp2(-double(pos) / double(last_frames)));
+      const float *f = src + (pos % last_frames) * ch;
+      for (size_t c = 0; c < ch; c++)
+        out[i * ch + c] = f[c] * g;
+    }
+    samples_from_float(ss.format, out, dst, frames * ch);
+
+    concealed += frames;
+  }
+
+  size_t JitterBuffer::pull(char *dst, size_t size) {
+    size_t frames = size / frame_size;
+
+    if (!playing) {
+      if (packets.empty() || depth() < target())
+        return 0;
+      playing = true;
+      buffering = false;
+      next = packets.begin()->first;
+      concealed = 0;
+    }
+
+    /* the buffer grew well past its target (a burst, or a smaller jitter
+       since): skip ahead rather than keep the extra latency */
+    size_t t = target();
+    if (depth() > 2 * t + packet_frames) {
+      int64_t to = end() - int64_t(t);
+      skipped += to - next;
+      next = to;
+    }
+
+    size_t done = 0;
+    while (done < frames) {
+      while (!packets.empty()) {
+        auto it = packets.begin();
+        if (it->first + int64_t(it->second.size() / frame_size) > next)
+          break;
+        stored -= it->second.size();
+        packets.erase(it);
+      }
+
+      char *out = dst + done * frame_size;
+
+      if (!packets.empty() && packets.begin()->first <= next) {
+        auto it = packets.begin();
+        size_t offset = size_t(next - it->first);
+        size_t avail = it->second.size() / frame_size - offset;
+        size_t n = std::min(avail, frames - done);
+
+        memcpy(out, it->second.data() + offset * frame_size, n * frame_size);
+        if (n == avail) {
+          /* played in full, keep it for concealment */
+          stored -= it->second.size();
+          last.swap(it->second);
+          packets.erase(it);
+        }
+        next += n;
+        done += n;
+        concealed = 0;
+        continue;
+      }
+
+      if (packets.empty() || buffering) {
+        /* ran dry: conceal without moving on, which adds the delay needed
+           to get back to the target depth; give up after a long silence */
+        if (!packets.empty() && depth() >= target()) {
+          buffering = false;
+          continue;
+        }
+        if (concealed >= max_depth) {
+          playing = false;
+          buffering = false;
+          break;
+        }
+        buffering = true;
+
+        size_t n = std::min(frames - done, max_depth - concealed);
+        conceal(out, n);
+        done += n;
+        lost += n;
+        continue;
+      }
+
+      /* a hole before the next packet: conceal it and move on */
+      size_t gap = std::min(frames - done, size_t(packets.begin()->first - next));
+      conceal(out, gap);
+      next += gap;
+      done += gap;
+      lost += gap;
+    }
+
+    return done * frame_size;
+  }
+}
@@ -0,0 +1,92 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __JITTER_HH__
+#define __JITTER_HH__
+
+#include "common.hh"
+
+#include <map>
+
+namespace pulse {
+  /* Playout buffer for timestamped packets, e.g. from RTP. Packets are
+     ordered by timestamp (in frames, wrapping at 32 bits) and played once
+     the buffer holds the target depth, which follows the interarrival
+     jitter (RFC 3550 estimate). Late packets are dropped and holes are
+     concealed by replaying the last packet with a decaying gain. When the
+     buffer runs dry, concealment goes on without moving the playout point
+     until the target depth is back, which grows the delay; a buffer that
+     grew too deep skips ahead. After too long a silence, playout stops. */
+  class JitterBuffer {
+  private:
+    pa_sample_spec ss;
+    size_t frame_size;
+    size_t min_depth;   /* frames */
+    size_t max_depth;   /* frames */
+
+    std::map<int64_t, std::vector<char>> packets;
+    size_t stored;      /* bytes */
+    int64_t last_ts;    /* unwrapped */
+    uint32_t last_raw;
+    bool have_ts;
+
+    bool playing;
+    bool buffering;     /* concealing until the target depth is back */
+    int64_t next;       /* next frame to play */
+
+    /* interarrival jitter, in frames */
+    double jitter;
+    double last_transit;
+    bool have_transit;
+    size_t packet_frames;
+
+    /* concealment */
+    std::vector<char> last;
+    std::vector<float> scratch;
+    size_t concealed;   /* consecutive frames */
+
+    int64_t end() const;
+    void conceal(char *dst, size_t frames);
+
+  public:
+    /* counters */
+    uint64_t received;
+    uint64_t late;
+    uint64_t lost;      /* frames concealed */
+    uint64_t skipped;   /* frames dropped to reduce the depth */
+    uint64_t refused;   /* packets dropped over the memory budget */
+
+    JitterBuffer(const pa_sample_spec& ss, pa_usec_t min_depth, pa_usec_t max_depth);
+
+    void push(uint32_t timestamp, const char *data, size_t size, double arrival_usec);
+
+    /* fills dst with up to size bytes of audio, returns how much */
+    size_t pull(char *dst, size_t size);
+
+    size_t bytes() const {
+      return stored;
+    }
+    size_t depth() const;
+    size_t target() const;
+    double jitter_frames() const {
+      return jitter;
+    }
+  };
+}
+
+#endif//__JITTER_HH__
@@ -0,0 +1,43 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __PROBES_HH__
+#define __PROBES_HH__
+
+/* Static tracepoints (USDT) on the audio paths, for bpftrace, perf or
+   systemtap, under the "pulse" provider. They are built when sys/sdt.h is
+   available (HAVE_SDT) and cost a nop each when nothing is attached.
+
+   Streams are identified by their address, sizes are in bytes. Take the
+   timestamps from the tracer (e.g. nsecs in bpftrace), so that a disabled
+   probe does not read the clock. */
+
+#ifdef HAVE_SDT
+#  include <sys/sdt.h>
+#  define PROBE0(name) DTRACE_PROBE(pulse, name)
+#  define PROBE1(name, a) DTRACE_PROBE1(pulse, name, a)
+#  define PROBE2(name, a, b) DTRACE_PROBE2(pulse, name, a, b)
+#  define PROBE3(name, a, b, c) DTRACE_PROBE3(pulse, name, a, b, c)
+#else// HAVE_SDT
+#  define PROBE0(name)
+#  define PROBE1(name, a)
+#  define PROBE2(name, a, b)
+#  define PROBE3(name, a, b, c)
+#endif// HAVE_SDT
+
+#endif//__PROBES_HH__
@@ -0,0 +1,294 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "recorder.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace pulse {
+  static const size_t wav_header_size = 44;
+  static const size_t min_ring = 65536;
+
+  static void put16(char *p, uint16_t v) {
+    p[0] = char(v);
+    p[1] = char(v >> 8);
+  }
+
+  static void put32(char *p, uint32_t v) {
+    p[0] = char(v);
+    p[1] = char(v >> 8);
+    p[2] = char(v >> 16);
+    p[3] = char(v >> 24);
+  }
+
+  static unsigned wav_tag(pa_sample_format_t format) {
+    switch (format) {
+    case PA_SAMPLE_U8:
+    case PA_SAMPLE_S16LE:
+    case PA_SAMPLE_S24LE:
+    case PA_SAMPLE_S32LE:
+      return 0x0001;
+    case PA_SAMPLE_FLOAT32LE:
+      return 0x0003;
+    case PA_SAMPLE_ALAW:
+      return 0x0006;
+    case PA_SAMPLE_ULAW:
+      return 0x0007;
+    default:
+      return 0;
+    }
+  }
+
+  bool recorder_format_supported(pa_sample_format_t format) {
+    return wav_tag(format) != 0;
+  }
+
+  Recorder::Recorder(const pa_sample_spec& ss_, bool wav_, RecorderSync sync_, pa_usec_t buffer, pa_usec_t flush,
+                     notify_cb_t notify_, void *notify_ud_) :
+    ss(ss_), wav(wav_), sync(sync_), fd(-1), head(0), tail(0), async(NULL), signalled(false),
+    stopping(false), finished(false), error(0), notify(notify_), notify_ud(notify_ud_),
+    written(0), dropped(0) {
+    size_t frame_size = pa_frame_size(&ss);
+
+    size_t size = std::max(pa_usec_to_bytes(buffer, &ss), min_ring);
+    ring.resize(size - size % frame_size);
+    flush_bytes = std::max(pa_usec_to_bytes(flush, &ss), frame_size);
+
+    uv_mutex_init(&mutex);
+    uv_cond_init(&cond);
+  }
+
+  Recorder::~Recorder() {
+    if (fd >= 0)
+      close(fd);
+    uv_cond_destroy(&cond);
+    uv_mutex_destroy(&mutex);
+  }
+
+  static void CloseAsync(uv_handle_t *handle) {
+    delete reinterpret_cast<uv_async_t*>(handle);
+  }
+
+  const char *Recorder::start(const char *path) {
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+      return strerror(errno);
+
+    if (wav && !patch_header())
+      return strerror(error);
+
+    async = new uv_async_t;
+    uv_async_init(uv_default_loop(), async, AsyncCallback);
+    async->data = this;
+
+    int status = uv_thread_create(&thread, Run, this);
+    if (status < 0) {
+      uv_close(reinterpret_cast<uv_handle_t*>(async), CloseAsync);
+      async = NULL;
+      return uv_strerror(status);
+    }
+
+    return NULL;
+  }
+
+  /* capture side */
+
+  void Recorder::append(const void *data, size_t size) {
+    if (error || finished)
+      return;
+
+    uint64_t h = head.load(std::memory_order_relaxed);
+    uint64_t t = tail.load(std::memory_order_acquire);
+    size_t capacity = ring.size();
+
+    /* never wait for the disk here, drop whole fragments instead */
+    if (size > capacity - size_t(h - t)) {
+      dropped += size;
+      return;
+    }
+
+    size_t offset = size_t(h % capacity);
+    size_t first = std::min(size, capacity - offset);
+    memcpy(ring.data() + offset, data, first);
+    memcpy(ring.data(), static_cast<const char*>(data) + first, size - first);
+    head.store(h + size, std::memory_order_release);
+
+    /* let the writer batch, unless the ring fills up */
+    if (h + size - t >= capacity / 4) {
+      uv_mutex_lock(&mutex);
+      if (!signalled) {
+        signalled = true;
+        uv_cond_signal(&cond);
+      }
+      uv_mutex_unlock(&mutex);
+    }
+  }
+
+  void Recorder::stop() {
+    uv_mutex_lock(&mutex);
+    stopping = true;
+    uv_cond_signal(&cond);
+    uv_mutex_unlock(&mutex);
+  }
+
+  void Recorder::detach() {
+    notify = NULL;
+    notify_ud = NULL;
+  }
+
+  const char *Recorder::failure() const {
+    return error ? strerror(error) : NULL;
+  }
+
+  /* writer thread */
+
+  void Recorder::Run(void *ud) {
+    static_cast<Recorder*>(ud)->run();
+  }
+
+  bool Recorder::write_all(const char *data, size_t size) {
+    while (size) {
+      ssize_t n = write(fd, data, size);
+      if (n < 0) {
+        if (errno == EINTR)
+          continue;
+        error = errno;
+        return false;
+      }
+      data += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  bool Recorder::patch_header() {
+    uint64_t data_size = written;
+    size_t frame_size = pa_frame_size(&ss);
+    char header[wav_header_size];
+
+    /* sizes saturate past 4GiB, readers then go by the file size */
+    uint32_t data_size32 = uint32_t(std::min<uint64_t>(data_size, UINT32_MAX - wav_header_size));
+
+    memcpy(header, "RIFF", 4);
+    put32(header + 4, data_size32 + wav_header_size - 8);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    put32(header + 16, 16);
+    put16(header + 20, wav_tag(ss.format));
+    put16(header + 22, ss.channels);
+    put32(header + 24, ss.rate);
+    put32(header + 28, ss.rate * frame_size);
+    put16(header + 32, frame_size);
+    put16(header + 34, pa_sample_size(&ss) * 8);
+    memcpy(header + 36, "data", 4);
+    put32(header + 40, data_size32);
+
+    if (pwrite(fd, header, wav_header_size, 0) != ssize_t(wav_header_size)) {
+      error = errno ? errno : EIO;
+      return false;
+    }
+    if (lseek(fd, 0, SEEK_END) < 0) {
+      error = errno;
+      return false;
+    }
+    return true;
+  }
+
+  void Recorder::run() {
+    size_t capacity = ring.size();
+    uint64_t flushed = 0;
+    uint64_t timeout = pa_bytes_to_usec(flush_bytes, &ss) * 1000;
+
+    for (;;) {
+      uv_mutex_lock(&mutex);
+      while (!signalled && !stopping) {
+        if (uv_cond_timedwait(&cond, &mutex, timeout) != 0)
+          break;
+      }
+      signalled = false;
+      uv_mutex_unlock(&mutex);
+
+      /* whatever was appended before stop() is written out */
+      bool last = stopping;
+
+      uint64_t t = tail.load(std::memory_order_relaxed);
+      uint64_t h = head.load(std::memory_order_acquire);
+      while (t < h) {
+        size_t offset = size_t(t % capacity);
+        size_t size = std::min(size_t(h - t), capacity - offset);
+        if (!write_all(ring.data() + offset, size))
+          break;
+        t += size;
+        written += size;
+        tail.store(t, std::memory_order_release);
+      }
+      if (error)
+        break;
+
+      if (written - flushed >= flush_bytes) {
+        if (wav && !patch_header())
+          break;
+        if (sync == RECORDER_SYNC_PERIODIC && fdatasync(fd) < 0) {
+          error = errno;
+          break;
+        }
+        flushed = written;
+        uv_async_send(async);
+      }
+
+      if (last)
+        break;
+    }
+
+    if (!error && wav)
+      patch_header();
+    if (!error && sync != RECORDER_SYNC_NONE && fsync(fd) < 0)
+      error = errno;
+    close(fd);
+    fd = -1;
+
+    finished = true;
+    uv_async_send(async);
+  }
+
+  /* back on the loop */
+
+  void Recorder::AsyncCallback(uv_async_t *handle) {
+    Recorder *recorder = static_cast<Recorder*>(handle->data);
+    bool done = recorder->finished;
+
+    if (recorder->notify)
+      recorder->notify(recorder->notify_ud, recorder, done);
+
+    if (done) {
+      uv_thread_join(&recorder->thread);
+      uv_close(reinterpret_cast<uv_handle_t*>(handle), CloseCallback);
+    }
+  }
+
+  void Recorder::CloseCallback(uv_handle_t *handle) {
+    Recorder *recorder = static_cast<Recorder*>(handle->data);
+
+    delete reinterpret_cast<uv_async_t*>(handle);
+    delete recorder;
+  }
+}
@@ -0,0 +1,114 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __RECORDER_HH__
+#define __RECORDER_HH__
+
+#include "common.hh"
+
+#include <atomic>
+#include <string>
+
+namespace pulse {
+  /* whether samples in that format can be stored in a WAV file */
+  bool recorder_format_supported(pa_sample_format_t format);
+
+  enum RecorderSync {
+    RECORDER_SYNC_NONE,
+    RECORDER_SYNC_CLOSE,     /* fsync once the file is complete */
+    RECORDER_SYNC_PERIODIC,  /* fdatasync at every flush interval, and on close */
+  };
+
+  /* Writes captured audio to a file from a thread of its own. The capture
+     side only copies fragments into a ring and never blocks: what does not
+     fit is dropped and counted. The writer drains the ring in large
+     batches, patches the WAV header and reports progress at every flush
+     interval, so a crash loses at most one interval of audio.
+
+     Once stopped, the recorder finishes writing in the background and
+     deletes itself after the final notification. */
+  class Recorder {
+  public:
+    typedef void (*notify_cb_t)(void *ud, Recorder *recorder, bool finished);
+
+  private:
+    pa_sample_spec ss;
+    bool wav;
+    RecorderSync sync;
+    size_t flush_bytes;
+
+    int fd;
+    std::vector<char> ring;
+    std::atomic<uint64_t> head;   /* bytes appended, owned by the capture side */
+    std::atomic<uint64_t> tail;   /* bytes consumed, owned by the writer */
+
+    uv_thread_t thread;
+    uv_mutex_t mutex;
+    uv_cond_t cond;
+    uv_async_t *async;
+    bool signalled;
+
+    std::atomic<bool> stopping;
+    std::atomic<bool> finished;
+    std::atomic<int> error;
+
+    notify_cb_t notify;
+    void *notify_ud;
+
+    static void Run(void *ud);
+    void run();
+    bool write_all(const char *data, size_t size);
+    bool patch_header();
+
+    static void AsyncCallback(uv_async_t *handle);
+    static void CloseCallback(uv_handle_t *handle);
+
+  public:
+    /* stats, readable from any thread */
+    std::atomic<uint64_t> written;   /* bytes of audio */
+    std::atomic<uint64_t> dropped;   /* bytes of audio */
+
+    Recorder(const pa_sample_spec& ss, bool wav, RecorderSync sync, pa_usec_t buffer, pa_usec_t flush, notify_cb_t notify, void *notify_ud);
+
+    /* only for a recorder that failed to start */
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    /* returns an error message, or NULL once the writer is running */
+    const char *start(const char *path);
+
+    /* from the capture side */
+    void append(const void *data, size_t size);
+
+    /* no more audio; the recorder must not be touched afterwards */
+    void stop();
+    void detach();
+
+    const pa_sample_spec& spec() const {
+      return ss;
+    }
+    size_t buffer_size() const {
+      return ring.size();
+    }
+    const char *failure() const;
+  };
+}
+
+#endif//__RECORDER_HH__
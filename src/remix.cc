@@ -0,0 +1,54 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "remix.hh"
+
+namespace pulse {
+  Remix::Remix(unsigned in_channels, unsigned out_channels, const std::vector<float>& matrix) :
+    in_channels(in_channels), out_channels(out_channels), matrix(matrix) {}
+
+  Remix::Remix(unsigned in_channels, unsigned out_channels) :
+    in_channels(in_channels), out_channels(out_channels), matrix(in_channels * out_channels, 0.0f) {
+    for (unsigned o = 0; o < out_channels; o++) {
+      float *row = matrix.data() + o * in_channels;
+      if (in_channels == 1) {
+        row[0] = 1.0f;
+      } else if (out_channels == 1) {
+        for (unsigned i = 0; i < in_channels; i++)
+          row[i] = 1.0f / float(in_channels);
+      } else if (o < in_channels) {
+        row[o] = 1.0f;
+      }
+    }
+  }
+
+  void Remix::process(const float *__restrict src, float *__restrict dst, size_t frames) const {
+    const unsigned in = in_channels, out = out_channels;
+    const float *m = matrix.data();
+
+    for (size_t f = 0; f < frames; f++, src += in, dst += out) {
+      for (unsigned o = 0; o < out; o++) {
+        const float *row = m + o * in;
+        float acc = 0.0f;
+        for (unsigned i = 0; i < in; i++)
+          acc += row[i] * src[i];
+        dst[o] = acc;
+      }
+    }
+  }
+}
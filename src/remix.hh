@@ -0,0 +1,51 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __REMIX_HH__
+#define __REMIX_HH__
+
+#include <cstddef>
+#include <vector>
+
+namespace pulse {
+  /* Channel mixing by a matrix of gains, one row per output channel with
+     one gain per input channel, on interleaved float samples. */
+  class Remix {
+  private:
+    unsigned in_channels;
+    unsigned out_channels;
+    std::vector<float> matrix;
+
+  public:
+    Remix(unsigned in_channels, unsigned out_channels, const std::vector<float>& matrix);
+    /* naive channel count adaptation: mono is duplicated or downmixed,
+       other layouts keep the channels they have in common */
+    Remix(unsigned in_channels, unsigned out_channels);
+
+    unsigned inputs() const {
+      return in_channels;
+    }
+    unsigned outputs() const {
+      return out_channels;
+    }
+
+    void process(const float *src, float *dst, size_t frames) const;
+  };
+}
+
+#endif//__REMIX_HH__
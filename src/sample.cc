@@ -0,0 +1,166 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "sample.hh"
+
+#include <cmath>
+
+namespace pulse {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  static const bool little_endian = true;
+#else
+  static const bool little_endian = false;
+#endif
+
+  template<typename T>
+  static inline T swap_if(T v, bool swap);
+
+  template<>
+  inline int16_t swap_if(int16_t v, bool swap) {
+    return swap ? int16_t(__builtin_bswap16(uint16_t(v))) : v;
+  }
+
+  template<>
+  inline int32_t swap_if(int32_t v, bool swap) {
+    return swap ? int32_t(__builtin_bswap32(uint32_t(v))) : v;
+  }
+
+  template<>
+  inline float swap_if(float v, bool swap) {
+    if (!swap)
+      return v;
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+    u = __builtin_bswap32(u);
+    memcpy(&v, &u, sizeof(v));
+    return v;
+  }
+
+  static inline float clamp(float v) {
+    return v > 1.0f ? 1.0f : (v < -1.0f ? -1.0f : v);
+  }
+
+  bool sample_format_supported(pa_sample_format_t format) {
+    switch(format) {
+    case PA_SAMPLE_U8:
+    case PA_SAMPLE_S16LE:
+    case PA_SAMPLE_S16BE:
+    case PA_SAMPLE_S32LE:
+    case PA_SAMPLE_S32BE:
+    case PA_SAMPLE_FLOAT32LE:
+    case PA_SAMPLE_FLOAT32BE:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  /* the loops below are kept branch-free so that the compiler vectorises them */
+
+  void samples_to_float(pa_sample_format_t format, const void *src, float *dst, size_t samples) {
+    switch(format) {
+    case PA_SAMPLE_U8: {
+      const uint8_t *s = static_cast<const uint8_t*>(src);
+      for (size_t i = 0; i < samples; i++)
+        dst[i] = (float(s[i]) - 128.0f) * (1.0f / 128.0f);
+      break;
+    }
+    case PA_SAMPLE_S16LE:
+    case PA_SAMPLE_S16BE: {
+      const int16_t *s = static_cast<const int16_t*>(src);
+      bool swap = (format == PA_SAMPLE_S16LE) != little_endian;
+      if (swap) {
+        for (size_t i = 0; i < samples; i++)
+          dst[i] = float(swap_if(s[i], true)) * (1.0f / 32768.0f);
+      } else {
+        for (size_t i = 0; i < samples; i++)
+          dst[i] = float(s[i]) * (1.0f / 32768.0f);
+      }
+      break;
+    }
+    case PA_SAMPLE_S32LE:
+    case PA_SAMPLE_S32BE: {
+      const int32_t *s = static_cast<const int32_t*>(src);
+      bool swap = (format == PA_SAMPLE_S32LE) != little_endian;
+      for (size_t i = 0; i < samples; i++)
+        dst[i] = float(swap_if(s[i], swap)) * (1.0f / 2147483648.0f);
+      break;
+    }
+    case PA_SAMPLE_FLOAT32LE:
+    case PA_SAMPLE_FLOAT32BE: {
+      const float *s = static_cast<const float*>(src);
+      bool swap = (format == PA_SAMPLE_FLOAT32LE) != little_endian;
+      if (swap) {
+        for (size_t i = 0; i < samples; i++)
+          dst[i] = swap_if(s[i], true);
+      } else if (s != dst) {
+        memcpy(dst, s, samples * sizeof(float));
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  void samples_from_float(pa_sample_format_t format, const float *src, void *dst, size_t samples) {
+    switch(format) {
+    case PA_SAMPLE_U8: {
+      uint8_t *d = static_cast<uint8_t*>(dst);
+      for (size_t i = 0; i < samples; i++)
+        d[i] = uint8_t(lrintf(clamp(src[i]) * 127.0f) + 128);
+      break;
+    }
+    case PA_SAMPLE_S16LE:
+    case PA_SAMPLE_S16BE: {
+      int16_t *d = static_cast<int16_t*>(dst);
+      bool swap = (format == PA_SAMPLE_S16LE) != little_endian;
+      if (swap) {
+        for (size_t i = 0; i < samples; i++)
+          d[i] = swap_if(int16_t(lrintf(clamp(src[i]) * 32767.0f)), true);
+      } else {
+        for (size_t i = 0; i < samples; i++)
+          d[i] = int16_t(lrintf(clamp(src[i]) * 32767.0f));
+      }
+      break;
+    }
+    case PA_SAMPLE_S32LE:
+    case PA_SAMPLE_S32BE: {
+      int32_t *d = static_cast<int32_t*>(dst);
+      bool swap = (format == PA_SAMPLE_S32LE) != little_endian;
+      for (size_t i = 0; i < samples; i++)
+        d[i] = swap_if(int32_t(llrint(double(clamp(src[i])) * 2147483647.0)), swap);
+      break;
+    }
+    case PA_SAMPLE_FLOAT32LE:
+    case PA_SAMPLE_FLOAT32BE: {
+      float *d = static_cast<float*>(dst);
+      bool swap = (format == PA_SAMPLE_FLOAT32LE) != little_endian;
+      if (swap) {
+        for (size_t i = 0; i < samples; i++)
+          d[i] = swap_if(src[i], true);
+      } else if (d != src) {
+        memcpy(d, src, samples * sizeof(float));
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+}
@@ -0,0 +1,33 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __SAMPLE_HH__
+#define __SAMPLE_HH__
+
+#include "common.hh"
+
+namespace pulse {
+  /* Conversion between interleaved stream samples and floats in [-1, 1],
+     which is the representation all native processing stages work on. */
+  bool sample_format_supported(pa_sample_format_t format);
+
+  void samples_to_float(pa_sample_format_t format, const void *src, float *dst, size_t samples);
+  void samples_from_float(pa_sample_format_t format, const float *src, void *dst, size_t samples);
+}
+
+#endif//__SAMPLE_HH__
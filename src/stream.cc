@@ -18,6 +18,9 @@
 // along with this library. If not, see <http://www.gnu.org/licenses/>.
 
 #include "stream.hh"
+#include "sample.hh"
+
+#include <algorithm>
 
 #ifdef DEBUG_STREAM
 #  undef LOG
@@ -31,15 +34,29 @@ namespace pulse {
                  Context& context,
                  Nan::Utf8String *stream_name,
                  const pa_sample_spec *sample_spec,
+                 const pa_channel_map *channel_map,
+                 pa_format_info *const *formats,
+                 unsigned n_formats,
                  pa_usec_t initial_latency,
                  pa_proplist* props):
-    isolate(_isolate), ctx(context), latency(initial_latency), write_offset(0) {
+    isolate(_isolate), ctx(context), extended(n_formats > 0), encoded(n_formats > 0),
+    clock_usec(0), clock_at(0), clock_last(0), clock_running(false), clock_updating(false),
+    direction(PA_STREAM_NODIRECTION), flags(PA_STREAM_NOFLAGS), user_corked(false), next_subscriber(1), analyser_accounted(0), recorder(NULL),
+    link_target(NULL), link_gain(1.0f), link_latency(0), link_dropped(0),
+    latency(initial_latency), write_offset(0), rate_sent(0), rate_wanted(0), rate_pending(false),
+    adaptive_pending(false), adaptive_applied(0),
+    idle_timer(NULL), idle_timeout(0), idle_silence(false), idle_corked(false), idle_waking(false), idle_last(0),
+    replace_pending(false), replaced_offset(0), replace_rewind(0), memory(0), queued(0), jitter_accounted(0) {
     
     ctx.Ref();
     
     pa_ss = *sample_spec;
+    rate_current = pa_ss.rate;
     
-    pa_stm = pa_stream_new_with_proplist(ctx.pa_ctx, stream_name ? **stream_name : "node-stream", &pa_ss, NULL, props);
+    if (extended)
+      pa_stm = pa_stream_new_extended(ctx.pa_ctx, stream_name ? **stream_name : "node-stream", formats, n_formats, props);
+    else
+      pa_stm = pa_stream_new_with_proplist(ctx.pa_ctx, stream_name ? **stream_name : "node-stream", &pa_ss, channel_map, props);
     
     buffer_attr.fragsize = (uint32_t)-1;
     buffer_attr.maxlength = (uint32_t)-1;
@@ -54,10 +71,18 @@ namespace pulse {
   }
   
   Stream::~Stream() {
+    idle(0, false);
+    if (recorder) {
+      recorder->detach();
+      recorder->stop();
+    }
+    for (Recorder *r : stopped_recorders)
+      r->detach();
     if (pa_stm) {
       disconnect();
       pa_stream_unref(pa_stm);
     }
+    account(-memory, -queued);
     ctx.Unref();
   }
   
@@ -66,6 +91,16 @@ namespace pulse {
     Nan::HandleScope scope;
     
     stm->pa_state = pa_stream_get_state(stm->pa_stm);
+    if (stm->pa_state == PA_STREAM_READY)
+      stm->clock_reset();
+
+    /* the server picked one of the formats */
+    if (stm->pa_state == PA_STREAM_READY && stm->extended) {
+      const pa_format_info *f = pa_stream_get_format_info(stm->pa_stm);
+      stm->encoded = !f || !pa_format_info_is_pcm(f);
+      stm->pa_ss = *pa_stream_get_sample_spec(stm->pa_stm);
+      stm->rate_current = stm->pa_ss.rate;
+    }
     
     if (!stm->state_callback.IsEmpty()) {
       v8::Local<v8::Value> args[] = {
@@ -88,6 +123,18 @@ namespace pulse {
     }
   }
   
+  void Stream::emit(const char *name, int argc, v8::Local<v8::Value> *argv) {
+    if (event_callback.IsEmpty())
+      return;
+
+    std::vector<v8::Local<v8::Value>> args(argc + 1);
+    args[0] = Nan::New(name).ToLocalChecked();
+    for (int i = 0; i < argc; i++)
+      args[i + 1] = argv[i];
+
+    Nan::MakeCallback(handle(), event_callback.Get(isolate), args.size(), args.data());
+  }
+  
   void Stream::BufferAttrCallback(pa_stream *s, void *ud) {
     Nan::HandleScope scope;
 #ifdef DEBUG
@@ -108,9 +155,57 @@ namespace pulse {
     LOG("latency %s%8d us", neg ? "-" : "", (int)usec);
     
     stm->latency = usec;
+
+    /* take a clock snapshot, clock() interpolates from it */
+    const pa_timing_info *ti = pa_stream_get_timing_info(stm->pa_stm);
+    if (ti && pa_stream_get_time(stm->pa_stm, &usec) >= 0) {
+      stm->clock_usec = double(usec);
+      stm->clock_at = double(uv_hrtime()) / 1000.0;
+      stm->clock_running = ti->playing && !pa_stream_is_corked(stm->pa_stm);
+    }
+  }
+
+  void Stream::ClockCallback(pa_stream *s, int success, void *ud) {
+    Stream *stm = static_cast<Stream*>(ud);
+
+    /* the snapshot itself is taken by LatencyCallback */
+    stm->clock_updating = false;
+  }
+
+  /* the stream time may go back, e.g. after a flush: let the clock follow
+     from the next timing update instead of holding the old high-water mark */
+  void Stream::clock_reset() {
+    clock_last = 0;
+  }
+
+  double Stream::clock() {
+    if (pa_stream_get_state(pa_stm) == PA_STREAM_READY &&
+        !(flags & PA_STREAM_AUTO_TIMING_UPDATE) && !clock_updating) {
+      pa_operation *op = pa_stream_update_timing_info(pa_stm, ClockCallback, this);
+      if (op) {
+        clock_updating = true;
+        pa_operation_unref(op);
+      }
+    }
+
+    double now = clock_usec;
+    if (clock_running)
+      now += double(uv_hrtime()) / 1000.0 - clock_at;
+
+    /* never go backwards when a timing update lands behind the interpolation */
+    if (now < clock_last)
+      now = clock_last;
+    clock_last = now;
+
+    return now;
   }
   
-  int Stream::connect(Nan::Utf8String *device_name, pa_stream_direction_t direction, pa_stream_flags_t flags) {
+  int Stream::connect(Nan::Utf8String *device_name, pa_stream_direction_t direction, pa_stream_flags_t flags, Stream *sync_stream) {
+    this->direction = direction;
+    this->flags = flags;
+
+    pa_stream_set_moved_callback(pa_stm, MovedCallback, this);
+
     switch(direction) {
     case PA_STREAM_PLAYBACK: {
       if (latency) {
@@ -121,8 +216,10 @@ namespace pulse {
       
       pa_stream_set_write_callback(pa_stm, RequestCallback, this);
       pa_stream_set_underflow_callback(pa_stm, UnderflowCallback, this);
+      pa_stream_set_started_callback(pa_stm, StartedCallback, this);
       
-      return pa_stream_connect_playback(pa_stm, device_name ? **device_name : NULL, &buffer_attr, flags, NULL, NULL);
+      return pa_stream_connect_playback(pa_stm, device_name ? **device_name : NULL, &buffer_attr, flags, NULL,
+                                        sync_stream ? sync_stream->pa_stm : NULL);
     }
     case PA_STREAM_RECORD: {
       if (latency) {
@@ -148,6 +245,30 @@ namespace pulse {
     pa_stream_disconnect(pa_stm);
   }
 
+  void Stream::StartedCallback(pa_stream *s, void *ud) {
+    Stream *stm = static_cast<Stream*>(ud);
+    Nan::HandleScope scope;
+
+    LOG("Stream::started");
+
+    /* monotonic, in the same time base as the clock snapshots */
+    v8::Local<v8::Value> args[] = { Nan::New(double(uv_hrtime()) / 1000.0) };
+    stm->emit("started", 1, args);
+  }
+
+  void Stream::MovedCallback(pa_stream *s, void *ud) {
+    Stream *stm = static_cast<Stream*>(ud);
+    Nan::HandleScope scope;
+
+    LOG("Stream::moved");
+
+    v8::Local<v8::Value> args[] = {
+      Nan::New(pa_stream_get_device_name(s)).ToLocalChecked(),
+      Nan::New(pa_stream_get_device_index(s))
+    };
+    stm->emit("moved", 2, args);
+  }
+
   void Stream::ReadCallback(pa_stream *s, size_t nb, void *ud) {
     Stream *stm = static_cast<Stream*>(ud);
     Nan::HandleScope scope;
@@ -158,7 +279,7 @@ namespace pulse {
   }
   
   void Stream::data() {
-    if (read_callback.IsEmpty()) {
+    if (!capturing()) {
       return;
     }
     
@@ -167,32 +288,407 @@ namespace pulse {
     
     pa_stream_peek(pa_stm, &data, &size);
     LOG("Stream::read callback %d", (int)size);
+    PROBE2(data, this, size);
     if (data == NULL) {
+      if (!read_callback.IsEmpty()) {
         v8::Local<v8::Value> args[] = { Null(isolate) };
         Nan::MakeCallback(handle(), read_callback.Get(isolate), 1, args);
+      }
     } else {
-        v8::Local<v8::Object> buffer = Nan::CopyBuffer((const char*)data, size).ToLocalChecked();
-        v8::Local<v8::Value> args[] = { buffer };
-        Nan::MakeCallback(handle(), read_callback.Get(isolate), 1, args);
+      if (recorder)
+        recorder->append(data, size);
+      if (link_target)
+        link_data(data, size);
+      if (analyser)
+        analyse(data, size);
+
+      /* one copy, processed once, whoever reads it from JS */
+      v8::Local<v8::Object> chunk;
+      if (!subscribers.empty() || !read_callback.IsEmpty()) {
+        if (remix) {
+          chunk = remixed(data, size);
+        } else {
+          chunk = Nan::CopyBuffer((const char*)data, size).ToLocalChecked();
+          if (processing())
+            process(node::Buffer::Data(chunk), size);
+        }
+      }
+
+      if (!subscribers.empty())
+        publish(chunk);
+      if (!read_callback.IsEmpty()) {
+        if (vad)
+          gate(data, size, chunk);
+        else
+          deliver(chunk);
+      }
     }
     if (!(data == NULL && size == 0)) {
         pa_stream_drop(pa_stm);
     }
   }
 
+  void Stream::deliver(v8::Local<v8::Object> buffer) {
+    if (read_callback.IsEmpty())
+      return;
+
+    v8::Local<v8::Value> args[] = { buffer };
+    Nan::MakeCallback(handle(), read_callback.Get(isolate), 1, args);
+  }
+
+  /* the detector listens to the captured audio, JS gets the processed chunk */
+  void Stream::gate(const void *data, size_t size, v8::Local<v8::Object> chunk) {
+    bool was_speaking = vad->speaking();
+    vad->analyse(data, size);
+    bool speaking = vad->speaking();
+
+    const char *processed = node::Buffer::Data(chunk);
+    size_t processed_size = node::Buffer::Length(chunk);
+    if (!was_speaking && !speaking) {
+      vad->remember(processed, processed_size);
+      return;
+    }
+
+    /* speech starts with the pre-roll, and ends with the chunk where it
+       stopped; there is no remix with a detector, frames line up */
+    v8::Local<v8::Object> buffer = chunk;
+    size_t preroll = was_speaking ? 0 : vad->remembered();
+    if (preroll) {
+      buffer = Nan::NewBuffer(uint32_t(preroll + processed_size)).ToLocalChecked();
+      char *dst = node::Buffer::Data(buffer);
+      vad->recall(dst);
+      memcpy(dst + preroll, processed, processed_size);
+    }
+
+    /* nothing below touches the detector, JS may replace it */
+    if (!was_speaking)
+      emit("speechstart");
+    deliver(buffer);
+    if (!speaking)
+      emit("speechend");
+  }
+
+  void Stream::analyse(const void *data, size_t size) {
+    size_t offset = 0;
+
+    while (analyser && offset < size) {
+      offset += analyser->analyse(static_cast<const char*>(data) + offset, size - offset);
+      account_analyser();
+      if (!analyser->ready())
+        break;
+
+      auto output = analyser_output.Get(isolate);
+      Nan::TypedArrayContents<float> contents(output);
+      memcpy(*contents, analyser->spectrum(), std::min(size_t(contents.length()), analyser->length()) * sizeof(float));
+
+      /* JS may replace the analyser, which goes on with the rest of the chunk */
+      v8::Local<v8::Value> args[] = { output };
+      emit("spectrum", 1, args);
+    }
+  }
+
   void Stream::read(v8::Local<v8::Value> callback) {
     if (callback->IsFunction()) {
       pa_stream_drop(pa_stm);
       read_callback = Nan::Global<v8::Function>(callback.As<v8::Function>());
       //pa_stream_drop(pa_stm);
       //pa_stream_flush(pa_stm, NULL, NULL);
-      pa_stream_cork(pa_stm, 0, NULL, NULL);
     } else {
-      pa_stream_cork(pa_stm, 1, NULL, NULL);
+      read_callback.Reset();
       pa_stream_drop(pa_stm);
       //pa_stream_flush(pa_stm, NULL, NULL);
-      read_callback.Reset();
     }
+    update_cork();
+  }
+
+  /* a record stream captures as long as anything consumes the audio */
+  bool Stream::capturing() const {
+    return !read_callback.IsEmpty() || link_target || recorder || !subscribers.empty() || analyser;
+  }
+
+  void Stream::update_cork() {
+    pa_stream_cork(pa_stm, !capturing(), NULL, NULL);
+  }
+
+  /* subscribers */
+
+  void Stream::publish(v8::Local<v8::Object> chunk) {
+    size_t size = node::Buffer::Length(chunk);
+    size_t frame_size = pa_frame_size(&pa_ss);
+
+    std::vector<uint32_t> ids;
+    for (auto& it : subscribers) {
+      Subscriber& sub = *it.second;
+
+      if (sub.queued + size > sub.limit || ctx.over_budget(size)) {
+        if (sub.policy == OVERFLOW_DROP_NEWEST) {
+          sub.dropped += size / frame_size;
+          continue;
+        }
+        while (!sub.queue.empty() && (sub.queued + size > sub.limit || ctx.over_budget(size))) {
+          size_t old = node::Buffer::Length(sub.queue.front().Get(isolate));
+          sub.queued -= old;
+          sub.dropped += old / frame_size;
+          sub.queue.pop_front();
+          account(0, -int64_t(old));
+        }
+        if (ctx.over_budget(size)) {
+          sub.dropped += size / frame_size;
+          continue;
+        }
+      }
+
+      sub.queue.emplace_back(chunk);
+      sub.queued += size;
+      account(0, size);
+      if (!sub.paused)
+        ids.push_back(it.first);
+    }
+
+    /* callbacks may subscribe or unsubscribe */
+    for (uint32_t id : ids)
+      flush_subscriber(id);
+  }
+
+  void Stream::flush_subscriber(uint32_t id) {
+    for (;;) {
+      auto it = subscribers.find(id);
+      if (it == subscribers.end())
+        return;
+      Subscriber& sub = *it->second;
+      if (sub.paused || sub.queue.empty())
+        return;
+
+      v8::Local<v8::Value> args[] = { sub.queue.front().Get(isolate) };
+      sub.queued -= node::Buffer::Length(args[0]);
+      sub.queue.pop_front();
+      account(0, -int64_t(node::Buffer::Length(args[0])));
+
+      v8::Local<v8::Value> more = Nan::MakeCallback(handle(), sub.callback.Get(isolate), 1, args);
+
+      it = subscribers.find(id);
+      if (it != subscribers.end() && !more.IsEmpty() && more->IsFalse())
+        it->second->paused = true;
+    }
+  }
+
+  /* recorder */
+
+  void Stream::record(Recorder *r) {
+    if (recorder) {
+      recorder->stop();
+      stopped_recorders.push_back(recorder);
+    }
+    recorder = r;
+    /* released once the recorder is done with its ring */
+    if (r)
+      account(r->buffer_size());
+    update_cork();
+  }
+
+  void Stream::RecorderCallback(void *ud, Recorder *r, bool finished) {
+    Stream *stm = static_cast<Stream*>(ud);
+    Nan::HandleScope scope;
+
+    size_t frame_size = pa_frame_size(&r->spec());
+    v8::Local<v8::Value> argv[] = {
+      Nan::New(double(r->written / frame_size)),
+      Nan::New(double(r->dropped / frame_size)),
+      Nan::Undefined()
+    };
+
+    if (!finished) {
+      stm->emit("recording", 2, argv);
+      return;
+    }
+    stm->account(-int64_t(r->buffer_size()));
+
+    /* a write error ends the recording without stop() */
+    if (stm->recorder == r)
+      stm->record(NULL);
+    /* deleted once this returns */
+    stm->stopped_recorders.erase(std::remove(stm->stopped_recorders.begin(), stm->stopped_recorders.end(), r),
+                                 stm->stopped_recorders.end());
+
+    if (r->failure())
+      argv[2] = Nan::New(r->failure()).ToLocalChecked();
+    stm->emit("recorded", 3, argv);
+  }
+
+  /* link */
+
+  void Stream::link(Stream *target, v8::Local<v8::Object> handle, float gain, pa_usec_t latency, double drift_ppm) {
+    /* hand the playback stream back its nominal rate */
+    if (link_drift && link_target && link_target != target)
+      link_target->update_rate(link_target->pa_ss.rate);
+
+    link_target = target;
+    link_gain = gain;
+    link_latency = latency;
+    link_dropped = 0;
+    link_drift.reset(target && drift_ppm > 0 ? new Drift(target->pa_ss.rate, latency, drift_ppm, double(uv_hrtime()) / 1000.0) : NULL);
+
+    if (target)
+      link_handle.Reset(handle);
+    else
+      link_handle.Reset();
+    update_cork();
+  }
+
+  void Stream::link_data(const void *data, size_t size) {
+    Stream *dst = link_target;
+    if (dst->pa_state != PA_STREAM_READY)
+      return;
+
+    size_t src_frame = pa_frame_size(&pa_ss);
+    size_t frames = size / src_frame;
+
+    /* hold the playback queue near the latency target by dropping input past it */
+    if (link_latency) {
+      pa_usec_t queued;
+      int negative;
+      if (pa_stream_get_latency(dst->pa_stm, &queued, &negative) >= 0 && !negative &&
+          queued > link_latency + pa_bytes_to_usec(size, &pa_ss)) {
+        LOG("link: dropping %d frames, queued %d us", (int)frames, (int)queued);
+        link_dropped += frames;
+        return;
+      }
+    }
+
+    /* the server buffer comes in blocks, which may be shorter */
+    const char *src = static_cast<const char*>(data);
+    while (frames) {
+      size_t written = link_write(src, frames);
+      if (!written) {
+        LOG("link: no room for %d frames", (int)frames);
+        link_dropped += frames;
+        break;
+      }
+      src += written * src_frame;
+      frames -= written;
+    }
+
+    if (link_drift) {
+      pa_usec_t queued;
+      int negative;
+      if (pa_stream_get_latency(dst->pa_stm, &queued, &negative) >= 0 && !negative)
+        dst->update_rate(link_drift->update(double(uv_hrtime()) / 1000.0, double(queued)));
+    }
+  }
+
+  /* writes what fits in one server buffer of the target, returns the frames written */
+  size_t Stream::link_write(const char *src, size_t frames) {
+    Stream *dst = link_target;
+    size_t dst_frame = pa_frame_size(&dst->pa_ss);
+
+    void *out;
+    size_t out_size = frames * dst_frame;
+    if (pa_stream_begin_write(dst->pa_stm, &out, &out_size) < 0 || !out)
+      return 0;
+    frames = std::min(frames, out_size / dst_frame);
+    out_size = frames * dst_frame;
+    if (!frames) {
+      pa_stream_cancel_write(dst->pa_stm);
+      return 0;
+    }
+
+    if (pa_ss.format == dst->pa_ss.format && pa_ss.channels == dst->pa_ss.channels && link_gain == 1.0f) {
+      memcpy(out, src, out_size);
+    } else {
+      size_t src_samples = frames * pa_ss.channels;
+      size_t dst_samples = frames * dst->pa_ss.channels;
+      if (link_scratch.size() < src_samples + dst_samples) {
+        size_t before = link_scratch.capacity();
+        link_scratch.resize(src_samples + dst_samples);
+        account(int64_t(link_scratch.capacity() - before) * int64_t(sizeof(float)));
+      }
+      float *in = link_scratch.data();
+      float *mixed = in + src_samples;
+
+      samples_to_float(pa_ss.format, src, in, src_samples);
+      if (pa_ss.channels == dst->pa_ss.channels) {
+        memcpy(mixed, in, src_samples * sizeof(float));
+      } else {
+        if (!link_remix || link_remix->inputs() != pa_ss.channels || link_remix->outputs() != dst->pa_ss.channels)
+          link_remix.reset(new Remix(pa_ss.channels, dst->pa_ss.channels));
+        link_remix->process(in, mixed, frames);
+      }
+      if (link_gain != 1.0f) {
+        const float g = link_gain;
+        for (size_t i = 0; i < dst_samples; i++)
+          mixed[i] *= g;
+      }
+      samples_from_float(dst->pa_ss.format, mixed, out, dst_samples);
+    }
+
+    if (dst->processing())
+      dst->process(out, out_size);
+
+    pa_stream_write(dst->pa_stm, out, out_size, NULL, 0, PA_SEEK_RELATIVE);
+
+    return frames;
+  }
+
+  /* rate */
+
+  static void ReturnAll(std::vector<std::unique_ptr<Pending>>& list, const char *error) {
+    auto done = std::move(list);
+    list.clear();
+    for (auto& p : done) {
+      p->Args(1);
+      if (error)
+        p->argv[0] = Nan::Global<v8::Value>(Nan::Error(error));
+      else
+        p->argv[0] = Nan::Global<v8::Value>(Nan::Undefined());
+      p->Return();
+    }
+  }
+
+  void Stream::update_rate(uint32_t rate) {
+    rate_wanted = rate;
+    if (rate_pending)
+      return;
+    if (rate == rate_current) {
+      ReturnAll(rate_waiting, NULL);
+      return;
+    }
+
+    pa_operation *op = pa_stream_update_sample_rate(pa_stm, rate, RateCallback, this);
+    if (!op) {
+      const char *error = pa_strerror(pa_context_errno(ctx.pa_ctx));
+      LOG("Stream::update_rate: %s", error);
+      rate_wanted = rate_current;
+      ReturnAll(rate_waiting, error);
+      return;
+    }
+    pa_operation_unref(op);
+    rate_pending = true;
+    rate_sent = rate;
+    rate_sending = std::move(rate_waiting);
+    rate_waiting.clear();
+  }
+
+  void Stream::RateCallback(pa_stream *s, int success, void *ud) {
+    Stream *stm = static_cast<Stream*>(ud);
+    Nan::HandleScope scope;
+
+    stm->rate_pending = false;
+    if (!success) {
+      /* do not insist, e.g. without variable_rate */
+      const char *error = pa_strerror(pa_context_errno(stm->ctx.pa_ctx));
+      stm->rate_wanted = stm->rate_current;
+      ReturnAll(stm->rate_sending, error);
+      ReturnAll(stm->rate_waiting, error);
+      return;
+    }
+
+    stm->rate_current = stm->rate_sent;
+    v8::Local<v8::Value> argv[] = { Nan::New(stm->rate_current) };
+    stm->emit("rate", 1, argv);
+    ReturnAll(stm->rate_sending, NULL);
+
+    /* the latest request wins */
+    stm->update_rate(stm->rate_wanted);
   }
 
   /* write */
@@ -206,6 +702,13 @@ namespace pulse {
 
   void Stream::drain() {
     LOG("Stream::drain");
+    PROBE1(drain, this);
+
+    /* woken up from idle: the first write may not fill the prebuffer */
+    if (idle_waking) {
+      idle_waking = false;
+      pa_stream_trigger(pa_stm, NULL, NULL);
+    }
 
     if (!write_buffer.IsEmpty()) {
       //LOG("Stream::drain buffer del");
@@ -224,13 +727,60 @@ namespace pulse {
 
   static void DummyFree(void *p) {}
 
+  static bool is_silence(const void *data, size_t size, const pa_sample_spec& ss) {
+    uint8_t silence;
+    pa_silence_memory(&silence, 1, &ss);
+
+    const uint8_t *p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+      if (p[i] != silence)
+        return false;
+    }
+    return true;
+  }
+
   void Stream::RequestCallback(pa_stream *s, size_t length, void *ud) {
     Stream *stm = static_cast<Stream*>(ud);
     Nan::HandleScope scope;
 
-    if (stm->request(length) < length) {
-      stm->drain();
+    PROBE2(request, stm, length);
+
+    /* nothing to send between writes is not a late request either */
+    if (stm->adaptive && (!stm->write_buffer.IsEmpty() || stm->file)) {
+      /* how long this loop iteration ran before getting to us */
+      double now = double(uv_hrtime()) / 1000.0;
+      double lag = now - double(uv_now(uv_default_loop())) * 1000.0;
+      pa_usec_t buffered = 0;
+      int negative = 0;
+      if (pa_stream_get_latency(stm->pa_stm, &buffered, &negative) < 0 || negative)
+        buffered = 0;
+      if (stm->adaptive->request(now, lag > 0 ? pa_usec_t(lag) : 0, buffered))
+        stm->adapt();
+    }
+
+    if (stm->jitter) {
+      stm->jitter_request(length);
+      return;
+    }
+
+    if (stm->file) {
+      stm->file_request(length);
+      return;
     }
+
+    stm->request(length);
+    if (stm->write_done())
+      stm->drain();
+  }
+
+  /* all of the JS buffer reached the server, short writes are taken up on
+     the next request */
+  bool Stream::write_done() {
+    if (write_buffer.IsEmpty())
+      return false;
+
+    size_t frame_size = remix ? pa_sample_size(&pa_ss) * remix->inputs() : pa_frame_size(&pa_ss);
+    return node::Buffer::Length(write_buffer.Get(isolate)) - write_offset < frame_size;
   }
 
   size_t Stream::request(size_t length) {
@@ -242,6 +792,13 @@ namespace pulse {
     size_t end_length = node::Buffer::Length(local_write_buffer) - write_offset;
     size_t write_length = length;
 
+    /* what is written has the channels of the remix input */
+    size_t in_frame_size = pa_frame_size(&pa_ss), out_frame_size = in_frame_size;
+    if (remix) {
+      in_frame_size = pa_sample_size(&pa_ss) * remix->inputs();
+      write_length = length / out_frame_size * in_frame_size;
+    }
+
     if (!end_length) {
       return 0;
     }
@@ -249,14 +806,118 @@ namespace pulse {
     if (write_length > end_length) {
       write_length = end_length;
     }
+    write_length = write_length / in_frame_size * in_frame_size;
 
     LOG("write req=%d offset=%d chunk=%d", length, write_offset, write_length);
-    
-    pa_stream_write(pa_stm, ((const char*)node::Buffer::Data(local_write_buffer)) + write_offset, write_length, DummyFree, 0, PA_SEEK_RELATIVE);
+
+    const char *src = ((const char*)node::Buffer::Data(local_write_buffer)) + write_offset;
+    write_length = push(src, write_length, DummyFree, NULL, true);
+    PROBE3(write, this, length, write_length);
     
     write_offset += write_length;
 
-    return write_length;
+    return write_length / in_frame_size * out_frame_size;
+  }
+
+  /* Sends data borrowed from elsewhere, which must stay valid until free_cb
+     is called with free_cb_data; returns how much was written. Remixable
+     data has the channels of the remix input, when there is one. */
+  size_t Stream::push(const char *src, size_t length, pa_free_cb_t free_cb, void *free_cb_data, bool remixable) {
+    if (idle_timer)
+      note_audio(src, length);
+
+    pa_seek_mode_t seek = PA_SEEK_RELATIVE;
+    int64_t offset = 0;
+    size_t replaced = 0;
+    if (replace_pending) {
+      seek = PA_SEEK_RELATIVE_ON_READ;
+      replaced = server_queued();
+    } else if (replace_rewind) {
+      /* the silence that already played cannot be written over */
+      offset = -int64_t(std::min(replace_rewind, server_queued()));
+    }
+
+    if (remix && remixable) {
+      /* mix into the server-side buffer; the old audio is in the stream
+         layout and the new one is not, so a replacement does not crossfade */
+      size_t in_frame_size = pa_sample_size(&pa_ss) * remix->inputs();
+      size_t out_frame_size = pa_frame_size(&pa_ss);
+      size_t total = length / in_frame_size;
+      size_t done = 0;
+      while (done < total) {
+        void *data;
+        size_t size = (total - done) * out_frame_size;
+        if (pa_stream_begin_write(pa_stm, &data, &size) < 0 || !data)
+          break;
+        size_t frames = std::min(total - done, size / out_frame_size);
+        if (!frames) {
+          pa_stream_cancel_write(pa_stm);
+          break;
+        }
+        float *in = float_scratch(frames * (remix->inputs() + remix->outputs()));
+        float *out = in + frames * remix->inputs();
+
+        samples_to_float(pa_ss.format, src + done * in_frame_size, in, frames * remix->inputs());
+        remix->process(in, out, frames);
+        process_float(out, frames);
+        samples_from_float(pa_ss.format, out, data, frames * remix->outputs());
+        if (done)
+          pa_stream_write(pa_stm, data, frames * out_frame_size, NULL, 0, PA_SEEK_RELATIVE);
+        else
+          pa_stream_write(pa_stm, data, frames * out_frame_size, NULL, offset, seek);
+        done += frames;
+      }
+      free_cb(free_cb_data);
+      if (!done)
+        return 0;
+      replace_rewind = 0;
+      if (replace_pending)
+        silence_tail(replaced, done * out_frame_size);
+      replace_pending = false;
+
+      return done * in_frame_size;
+    } else if (processing() || replace_pending) {
+      /* process a copy in the server-side buffer, the source is not ours to
+         modify; the buffer comes in blocks, which may be shorter */
+      size_t frame_size = pa_frame_size(&pa_ss);
+      size_t written = 0;
+      while (written < length) {
+        void *data;
+        size_t size = length - written;
+        if (pa_stream_begin_write(pa_stm, &data, &size) < 0 || !data)
+          break;
+        size = std::min(size, length - written) / frame_size * frame_size;
+        if (!size) {
+          pa_stream_cancel_write(pa_stm);
+          break;
+        }
+        memcpy(data, src + written, size);
+        if (processing())
+          process(data, size);
+        if (replace_pending && !written)
+          crossfade(data, size);
+        if (written)
+          pa_stream_write(pa_stm, data, size, NULL, 0, PA_SEEK_RELATIVE);
+        else
+          pa_stream_write(pa_stm, data, size, NULL, offset, seek);
+        written += size;
+      }
+      free_cb(free_cb_data);
+      if (!written)
+        return 0;
+      replace_rewind = 0;
+      if (replace_pending)
+        silence_tail(replaced, written);
+      length = written;
+    } else if (pa_stream_write_ext_free(pa_stm, src, length, free_cb, free_cb_data, offset, seek) < 0) {
+      free_cb(free_cb_data);
+      return 0;
+    } else {
+      replace_rewind = 0;
+    }
+    replace_pending = false;
+
+    return length;
   }
 
   void Stream::UnderflowCallback(pa_stream *s, void *ud) {
@@ -268,12 +929,66 @@ namespace pulse {
 
   void Stream::underflow() {
     LOG("underflow");
+    PROBE1(underflow, this);
+
+    /* running out of audio between writes is not the stream's fault */
+    if (adaptive && (!write_buffer.IsEmpty() || file)) {
+      if (adaptive->underrun(double(uv_hrtime()) / 1000.0))
+        adapt();
+    }
+  }
+
+  void Stream::adapt() {
+    /* one change in flight at a time, the callback catches up */
+    if (adaptive_pending || adaptive->value() == adaptive_applied)
+      return;
+
+    pa_buffer_attr attr = buffer_attr;
+    attr.tlength = pa_usec_to_bytes(adaptive->value(), &pa_ss);
+    attr.maxlength = (uint32_t)-1;
+    attr.minreq = (uint32_t)-1;
+    attr.prebuf = (uint32_t)-1;
+
+    pa_operation *op = pa_stream_set_buffer_attr(pa_stm, &attr, AdaptiveCallback, this);
+    if (!op)
+      return;
+    pa_operation_unref(op);
+
+    adaptive_pending = true;
+    adaptive_applied = adaptive->value();
+  }
+
+  void Stream::AdaptiveCallback(pa_stream *s, int success, void *ud) {
+    Stream *stm = static_cast<Stream*>(ud);
+    Nan::HandleScope scope;
+
+    stm->adaptive_pending = false;
+
+    if (success) {
+      const pa_buffer_attr *ba = pa_stream_get_buffer_attr(s);
+      if (ba)
+        stm->buffer_attr = *ba;
+      LOG_BA(stm->buffer_attr);
+
+      v8::Local<v8::Value> argv[] = {
+        Nan::New(double(pa_bytes_to_usec(stm->buffer_attr.tlength, &stm->pa_ss)))
+      };
+      stm->emit("latency", 1, argv);
+    }
+
+    if (stm->adaptive)
+      stm->adapt();
   }
 
   void Stream::write(v8::Local<v8::Value> buffer, v8::Local<v8::Value> callback) {
+    /* writing from JS takes over from a file being played, or packets */
+    file.reset();
+    jitter.reset();
+    account_jitter();
+
     if (!write_buffer.IsEmpty()) {
       //LOG("Stream::write flush");
-      pa_stream_flush(pa_stm, DrainCallback, this);
+      flush(DrainCallback, this);
     }
 
     if (callback->IsFunction()) {
@@ -281,69 +996,458 @@ namespace pulse {
       drain_callback = Nan::Global<v8::Function>(callback.As<v8::Function>());
     }
 
+    if (idle_corked && node::Buffer::HasInstance(buffer)) {
+      if (idle_silence && is_silence(node::Buffer::Data(buffer), node::Buffer::Length(buffer), pa_ss) && !encoded) {
+        /* still nothing to play, stay corked */
+        drain();
+        return;
+      }
+      /* uncorked below, playback starts once the prebuffer is full or
+         the chunk is written in full */
+      wake();
+      idle_waking = true;
+    }
+
     if (node::Buffer::HasInstance(buffer)) {
       //LOG("Stream::write buffer add");
       write_buffer = Nan::Global<v8::Value>(buffer);
       write_offset = 0;
       LOG("Stream::write");
 
-      if (pa_stream_is_corked(pa_stm))
+      if (pa_stream_is_corked(pa_stm) && !user_corked)
         pa_stream_cork(pa_stm, 0, NULL, NULL);
       
+      /* a replacement may write over all the queued audio at once */
       size_t length = pa_stream_writable_size(pa_stm);
-      if (length > 0) {
-        if (request(length) < length) {
-          drain();
-        }
-      }
+      if (replace_pending)
+        length += server_queued();
+      if (length > 0)
+        request(length);
+      if (write_done())
+        drain();
     } else {
-      pa_stream_flush(pa_stm, NULL, NULL);
+      flush(NULL, NULL);
     }
   }
 
-  /* bindings */
+  /* idle */
 
-  void
-  Stream::Init(v8::Local<v8::Object> target) {
-    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
-    
-    tpl->SetClassName(Nan::New("PulseAudioStream").ToLocalChecked());
-    tpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-    Nan::SetPrototypeMethod(tpl, "connect", Connect);
-    Nan::SetPrototypeMethod(tpl, "disconnect", Disconnect);
-    
-    Nan::SetPrototypeMethod(tpl, "latency", Latency);
-    Nan::SetPrototypeMethod(tpl, "read", Read);
-    Nan::SetPrototypeMethod(tpl, "write", Write);
+  void Stream::idle(pa_usec_t timeout, bool silence) {
+    if (!timeout) {
+      if (idle_timer) {
+        uv_timer_stop(idle_timer);
+        uv_close((uv_handle_t*)idle_timer, [](uv_handle_t *h) { delete (uv_timer_t*)h; });
+        idle_timer = NULL;
+      }
+      return;
+    }
 
-    auto cfn = Nan::GetFunction(tpl).ToLocalChecked();
-    Nan::Set(target, Nan::New("Stream").ToLocalChecked(), cfn);
+    idle_timeout = double(timeout);
+    idle_silence = silence;
+    idle_last = double(uv_hrtime()) / 1000.0;
 
-    AddEmptyObject(cfn, type);
-    DefineConstant(type, playback, PA_STREAM_PLAYBACK);
-    DefineConstant(type, record, PA_STREAM_RECORD);
-    DefineConstant(type, upload, PA_STREAM_UPLOAD);
+    if (!idle_timer) {
+      idle_timer = new uv_timer_t;
+      uv_timer_init(uv_default_loop(), idle_timer);
+      idle_timer->data = this;
+      /* not a reason to keep the process alive */
+      uv_unref((uv_handle_t*)idle_timer);
+    }
+    uint64_t period = std::max<uint64_t>(timeout / 4000, 10);
+    uv_timer_start(idle_timer, IdleCallback, period, period);
+  }
 
-    AddEmptyObject(cfn, format);
-    DefineConstant(format, U8, PA_SAMPLE_U8);
-    DefineConstant(format, S16LE, PA_SAMPLE_S16LE);
-    DefineConstant(format, S16BE, PA_SAMPLE_S16BE);
-    DefineConstant(format, F32LE, PA_SAMPLE_FLOAT32LE);
-    DefineConstant(format, F32BE, PA_SAMPLE_FLOAT32BE);
-    DefineConstant(format, ALAW, PA_SAMPLE_ALAW);
-    DefineConstant(format, ULAW, PA_SAMPLE_ULAW);
-    DefineConstant(format, S32LE, PA_SAMPLE_S32LE);
-    DefineConstant(format, S32BE, PA_SAMPLE_S32BE);
-    DefineConstant(format, S24LE, PA_SAMPLE_S24LE);
-    DefineConstant(format, S24BE, PA_SAMPLE_S24BE);
-    DefineConstant(format, S24_32LE, PA_SAMPLE_S24_32LE);
-    DefineConstant(format, S24_32BE, PA_SAMPLE_S24_32BE);
+  void Stream::IdleCallback(uv_timer_t *timer) {
+    Stream *stm = static_cast<Stream*>(timer->data);
+    Nan::HandleScope scope;
 
-    AddEmptyObject(cfn, flags);
-    DefineConstant(flags, noflags, PA_STREAM_NOFLAGS);
-    DefineConstant(flags, start_corked, PA_STREAM_START_CORKED);
-    DefineConstant(flags, interpolate_timing, PA_STREAM_INTERPOLATE_TIMING);
+    stm->idle_check();
+  }
+
+  void Stream::note_audio(const void *data, size_t size) {
+    if (size && (!idle_silence || encoded || !is_silence(data, size, pa_ss)))
+      idle_last = double(uv_hrtime()) / 1000.0;
+  }
+
+  /* out of the idle cork, the caller uncorks the stream */
+  void Stream::wake() {
+    if (!idle_corked)
+      return;
+
+    idle_corked = false;
+    idle_last = double(uv_hrtime()) / 1000.0;
+    emit("active");
+  }
+
+  void Stream::idle_check() {
+    if (idle_corked || user_corked || pa_stream_get_state(pa_stm) != PA_STREAM_READY)
+      return;
+    if (double(uv_hrtime()) / 1000.0 - idle_last < idle_timeout)
+      return;
+
+    /* audio fed natively is never idle; written silence only is with idle_silence */
+    if (file || jitter || (!write_buffer.IsEmpty() && !idle_silence))
+      return;
+
+    LOG("Stream::idle");
+    idle_corked = true;
+
+    /* what is queued is silence, or has played out long ago: drop it, so
+       that the stream starts afresh on the next write */
+    if (!write_buffer.IsEmpty())
+      drain();
+    flush(NULL, NULL);
+    pa_stream_cork(pa_stm, 1, NULL, NULL);
+    emit("idle");
+  }
+
+  /* jitter buffer */
+
+  size_t Stream::jitter_request(size_t length) {
+    void *data;
+    size_t size = length;
+
+    /* packets are pulled straight into the server-side buffer */
+    if (pa_stream_begin_write(pa_stm, &data, &size) < 0 || !data)
+      return 0;
+
+    size = jitter->pull(static_cast<char*>(data), size);
+    account_jitter();
+    if (idle_timer)
+      note_audio(data, size);
+    if (!size) {
+      pa_stream_cancel_write(pa_stm);
+      return 0;
+    }
+
+    if (processing())
+      process(data, size);
+    pa_stream_write(pa_stm, data, size, NULL, 0, PA_SEEK_RELATIVE);
+
+    return size;
+  }
+
+  /* file playback */
+
+  void Stream::play(FileSource *source) {
+    LOG("Stream::play");
+
+    /* the file replaces whatever JS was writing */
+    if (!write_buffer.IsEmpty()) {
+      flush(NULL, NULL);
+      drain();
+    }
+    jitter.reset();
+    account_jitter();
+    file.reset(source);
+
+    wake();
+    if (pa_stream_is_corked(pa_stm) && !user_corked)
+      pa_stream_cork(pa_stm, 0, NULL, NULL);
+
+    size_t length = pa_stream_writable_size(pa_stm);
+    if (length > 0 && length != size_t(-1))
+      file_request(length);
+  }
+
+  size_t Stream::file_request(size_t length) {
+    size_t written = 0;
+
+    while (written < length) {
+      size_t size = length - written;
+      const char *src = file->next(&size);
+
+      if (!src) {
+        /* let what was queued play out */
+        LOG("Stream::file_request end");
+        file.reset();
+        emit("played");
+        break;
+      }
+
+      /* files are in the stream layout, the remix only applies to JS writes */
+      size_t pushed = push(src, size, FileSource::Unref, file->ref(), false);
+      written += pushed;
+      if (pushed < size) {
+        /* the server buffer is full, rewind to what was not written */
+        file->unread(size - pushed);
+        break;
+      }
+    }
+
+    return written;
+  }
+
+  void Stream::stop() {
+    if (!file)
+      return;
+
+    file.reset();
+    flush(NULL, NULL);
+  }
+
+  /* barge-in */
+
+  static const pa_usec_t crossfade_usec = 5000;
+
+  void Stream::replace() {
+    LOG("Stream::replace");
+
+    /* keep the buffer being played around: it holds the audio we fade out from */
+    replaced_buffer.Reset();
+    if (!write_buffer.IsEmpty()) {
+      replaced_buffer.Reset(write_buffer.Get(isolate));
+      replaced_offset = write_offset;
+    }
+    replace_pending = true;
+    clock_reset();
+
+    /* the pending write is over as far as JS is concerned */
+    drain();
+  }
+
+  /* drops what is queued in the server, and with it what was written to
+     be gone back over and the clock high-water mark */
+  void Stream::flush(pa_stream_success_cb_t cb, void *ud) {
+    replace_rewind = 0;
+    clock_reset();
+    pa_stream_flush(pa_stm, cb, ud);
+  }
+
+  /* bytes between the read and write indexes, which a replacement writes over */
+  size_t Stream::server_queued() {
+    const pa_timing_info *ti = pa_stream_get_timing_info(pa_stm);
+    if (!ti || ti->read_index_corrupt || ti->write_index_corrupt)
+      return 0;
+
+    /* the read index moved on since the last timing update */
+    int64_t read_index = ti->read_index;
+    if (ti->playing)
+      read_index += pa_usec_to_bytes(pa_timeval_age(&ti->timestamp), &pa_ss);
+
+    int64_t queued = ti->write_index - read_index;
+    size_t frame_size = pa_frame_size(&pa_ss);
+    return queued > 0 ? size_t(queued) / frame_size * frame_size : 0;
+  }
+
+  /* the old audio past a shorter replacement would still play */
+  void Stream::silence_tail(size_t queued, size_t written) {
+    size_t frame_size = pa_frame_size(&pa_ss);
+    while (queued > written) {
+      void *data;
+      size_t size = queued - written;
+      if (pa_stream_begin_write(pa_stm, &data, &size) < 0 || !data)
+        break;
+      size = std::min(size, queued - written) / frame_size * frame_size;
+      if (!size) {
+        pa_stream_cancel_write(pa_stm);
+        break;
+      }
+      pa_silence_memory(data, size, &pa_ss);
+      pa_stream_write(pa_stm, data, size, NULL, 0, PA_SEEK_RELATIVE);
+      written += size;
+      replace_rewind += size;
+    }
+  }
+
+  void Stream::crossfade(void *data, size_t size) {
+    size_t frame_size = pa_frame_size(&pa_ss);
+    size_t frames = std::min(pa_usec_to_bytes(crossfade_usec, &pa_ss), size) / frame_size;
+    size_t samples = frames * pa_ss.channels;
+
+    if (!frames || !processable()) {
+      replaced_buffer.Reset();
+      return;
+    }
+
+    /* find the old audio at the read index, which is where the new one lands */
+    const char *old = NULL;
+    if (!replaced_buffer.IsEmpty()) {
+      size_t queued = server_queued();
+      if (queued <= replaced_offset &&
+          replaced_offset - queued + frames * frame_size <= node::Buffer::Length(replaced_buffer.Get(isolate)))
+        old = node::Buffer::Data(replaced_buffer.Get(isolate)) + replaced_offset - queued;
+    }
+
+    float *fresh = float_scratch(2 * samples);
+    float *faded = fresh + samples;
+
+    samples_to_float(pa_ss.format, data, fresh, samples);
+    if (old)
+      samples_to_float(pa_ss.format, old, faded, samples);
+    else
+      std::fill(faded, faded + samples, 0.0f);
+
+    /* equal-gain crossfade; without old audio this is a short fade in */
+    for (size_t f = 0; f < frames; f++) {
+      float t = float(f + 1) / float(frames);
+      for (unsigned c = 0; c < pa_ss.channels; c++) {
+        size_t i = f * pa_ss.channels + c;
+        fresh[i] = fresh[i] * t + faded[i] * (1.0f - t);
+      }
+    }
+
+    samples_from_float(pa_ss.format, fresh, data, samples);
+    replaced_buffer.Reset();
+  }
+
+  static void StreamSuccessCallback(pa_stream *s, int success, void *ud) {
+    Pending *p = static_cast<Pending*>(ud);
+    Nan::HandleScope scope;
+
+    if (!p->Args()) {
+      p->Args(1);
+      p->argv[0] = Nan::Global<v8::Value>(Nan::Undefined());
+    }
+
+    p->Return();
+    delete p;
+  }
+
+  /* memory */
+
+  void Stream::account(int64_t native_delta, int64_t queued_delta) {
+    memory += native_delta;
+    queued += queued_delta;
+    ctx.account(native_delta, queued_delta);
+  }
+
+  void Stream::account_jitter() {
+    size_t bytes = jitter ? jitter->bytes() : 0;
+    account(int64_t(bytes) - int64_t(jitter_accounted));
+    jitter_accounted = bytes;
+  }
+
+  void Stream::account_analyser() {
+    size_t bytes = analyser ? analyser->memory() : 0;
+    account(int64_t(bytes) - int64_t(analyser_accounted));
+    analyser_accounted = bytes;
+  }
+
+  /* processing */
+
+  bool Stream::processing() const {
+    return gain.active() || (eq && eq->active());
+  }
+
+  float *Stream::float_scratch(size_t samples) {
+    if (scratch.size() < samples) {
+      size_t before = scratch.capacity();
+      scratch.resize(samples);
+      account(int64_t(scratch.capacity() - before) * int64_t(sizeof(float)));
+    }
+    return scratch.data();
+  }
+
+  void Stream::process(void *data, size_t size) {
+    size_t frames = size / pa_frame_size(&pa_ss);
+    size_t samples = frames * pa_ss.channels;
+    float *f = float_scratch(samples);
+
+    samples_to_float(pa_ss.format, data, f, samples);
+    process_float(f, frames);
+    samples_from_float(pa_ss.format, f, data, samples);
+  }
+
+  /* the stages, on frames with the channels of the stream */
+  void Stream::process_float(float *data, size_t frames) {
+    if (eq)
+      eq->process(data, frames);
+    gain.process(data, frames, pa_ss.channels);
+  }
+
+  /* a processed copy of captured audio, with the channels of the remix output */
+  v8::Local<v8::Object> Stream::remixed(const void *data, size_t size) {
+    size_t frames = size / pa_frame_size(&pa_ss);
+    float *in = float_scratch(frames * (remix->inputs() + remix->outputs()));
+    float *out = in + frames * remix->inputs();
+
+    samples_to_float(pa_ss.format, data, in, frames * remix->inputs());
+    process_float(in, frames);
+    remix->process(in, out, frames);
+
+    v8::Local<v8::Object> chunk = Nan::NewBuffer(uint32_t(frames * pa_sample_size(&pa_ss) * remix->outputs())).ToLocalChecked();
+    samples_from_float(pa_ss.format, out, node::Buffer::Data(chunk), frames * remix->outputs());
+    return chunk;
+  }
+
+  /* bindings */
+
+  void
+  Stream::Init(v8::Local<v8::Object> target) {
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+    
+    tpl->SetClassName(Nan::New("PulseAudioStream").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+    
+    Nan::SetPrototypeMethod(tpl, "connect", Connect);
+    Nan::SetPrototypeMethod(tpl, "disconnect", Disconnect);
+    Nan::SetPrototypeMethod(tpl, "monitor", Monitor);
+    Nan::SetPrototypeMethod(tpl, "index", Index);
+    Nan::SetPrototypeMethod(tpl, "device", Device);
+    Nan::SetPrototypeMethod(tpl, "events", Events);
+    Nan::SetPrototypeMethod(tpl, "cork", Cork);
+    
+    Nan::SetPrototypeMethod(tpl, "latency", Latency);
+    Nan::SetPrototypeMethod(tpl, "time", Time);
+    Nan::SetPrototypeMethod(tpl, "clock", Clock);
+    Nan::SetPrototypeMethod(tpl, "timing", Timing);
+    Nan::SetPrototypeMethod(tpl, "update_timing", UpdateTiming);
+    Nan::SetPrototypeMethod(tpl, "read", Read);
+    Nan::SetPrototypeMethod(tpl, "write", Write);
+    Nan::SetPrototypeMethod(tpl, "link", Link);
+    Nan::SetPrototypeMethod(tpl, "replace", Replace);
+    Nan::SetPrototypeMethod(tpl, "trigger", Trigger);
+    Nan::SetPrototypeMethod(tpl, "gain", SetGain);
+    Nan::SetPrototypeMethod(tpl, "memory", Memory);
+    Nan::SetPrototypeMethod(tpl, "format_info", FormatInfo);
+    Nan::SetPrototypeMethod(tpl, "remix", SetRemix);
+    Nan::SetPrototypeMethod(tpl, "eq", SetEq);
+    Nan::SetPrototypeMethod(tpl, "eq_truncate", TruncateEq);
+    Nan::SetPrototypeMethod(tpl, "vad", SetVad);
+    Nan::SetPrototypeMethod(tpl, "analyser", SetAnalyser);
+    Nan::SetPrototypeMethod(tpl, "adaptive", SetAdaptive);
+    Nan::SetPrototypeMethod(tpl, "update_rate", UpdateRate);
+    Nan::SetPrototypeMethod(tpl, "idle", SetIdle);
+    Nan::SetPrototypeMethod(tpl, "jitter", SetJitter);
+    Nan::SetPrototypeMethod(tpl, "packet", Packet);
+    Nan::SetPrototypeMethod(tpl, "jitter_stats", JitterStats);
+    Nan::SetPrototypeMethod(tpl, "subscribe", Subscribe);
+    Nan::SetPrototypeMethod(tpl, "unsubscribe", Unsubscribe);
+    Nan::SetPrototypeMethod(tpl, "resume_subscriber", ResumeSubscriber);
+    Nan::SetPrototypeMethod(tpl, "subscriber_stats", SubscriberStats);
+    Nan::SetPrototypeMethod(tpl, "record", Record);
+    Nan::SetPrototypeMethod(tpl, "play", Play);
+    Nan::SetPrototypeMethod(tpl, "seek", Seek);
+    Nan::SetPrototypeMethod(tpl, "stop", Stop);
+
+    auto cfn = Nan::GetFunction(tpl).ToLocalChecked();
+    Nan::Set(target, Nan::New("Stream").ToLocalChecked(), cfn);
+
+    AddEmptyObject(cfn, type);
+    DefineConstant(type, playback, PA_STREAM_PLAYBACK);
+    DefineConstant(type, record, PA_STREAM_RECORD);
+    DefineConstant(type, upload, PA_STREAM_UPLOAD);
+
+    AddEmptyObject(cfn, format);
+    DefineConstant(format, U8, PA_SAMPLE_U8);
+    DefineConstant(format, S16LE, PA_SAMPLE_S16LE);
+    DefineConstant(format, S16BE, PA_SAMPLE_S16BE);
+    DefineConstant(format, F32LE, PA_SAMPLE_FLOAT32LE);
+    DefineConstant(format, F32BE, PA_SAMPLE_FLOAT32BE);
+    DefineConstant(format, ALAW, PA_SAMPLE_ALAW);
+    DefineConstant(format, ULAW, PA_SAMPLE_ULAW);
+    DefineConstant(format, S32LE, PA_SAMPLE_S32LE);
+    DefineConstant(format, S32BE, PA_SAMPLE_S32BE);
+    DefineConstant(format, S24LE, PA_SAMPLE_S24LE);
+    DefineConstant(format, S24BE, PA_SAMPLE_S24BE);
+    DefineConstant(format, S24_32LE, PA_SAMPLE_S24_32LE);
+    DefineConstant(format, S24_32BE, PA_SAMPLE_S24_32BE);
+
+    AddEmptyObject(cfn, flags);
+    DefineConstant(flags, noflags, PA_STREAM_NOFLAGS);
+    DefineConstant(flags, start_corked, PA_STREAM_START_CORKED);
+    DefineConstant(flags, interpolate_timing, PA_STREAM_INTERPOLATE_TIMING);
     DefineConstant(flags, not_monotonic, PA_STREAM_NOT_MONOTONIC);
     DefineConstant(flags, auto_timing_update, PA_STREAM_AUTO_TIMING_UPDATE);
     DefineConstant(flags, no_remap_channels, PA_STREAM_NO_REMAP_CHANNELS);
@@ -363,6 +1467,37 @@ namespace pulse {
     DefineConstant(flags, relative_volume, PA_STREAM_RELATIVE_VOLUME);
     DefineConstant(flags, passthrough, PA_STREAM_PASSTHROUGH);
 
+    AddEmptyObject(cfn, curve);
+    DefineConstant(curve, linear, GAIN_LINEAR);
+    DefineConstant(curve, exponential, GAIN_EXPONENTIAL);
+
+    AddEmptyObject(cfn, encoding);
+    DefineConstant(encoding, any, PA_ENCODING_ANY);
+    DefineConstant(encoding, pcm, PA_ENCODING_PCM);
+    DefineConstant(encoding, ac3_iec61937, PA_ENCODING_AC3_IEC61937);
+    DefineConstant(encoding, eac3_iec61937, PA_ENCODING_EAC3_IEC61937);
+    DefineConstant(encoding, mpeg_iec61937, PA_ENCODING_MPEG_IEC61937);
+    DefineConstant(encoding, dts_iec61937, PA_ENCODING_DTS_IEC61937);
+    DefineConstant(encoding, mpeg2_aac_iec61937, PA_ENCODING_MPEG2_AAC_IEC61937);
+
+    AddEmptyObject(cfn, filter);
+    DefineConstant(filter, lowpass, FILTER_LOWPASS);
+    DefineConstant(filter, highpass, FILTER_HIGHPASS);
+    DefineConstant(filter, bandpass, FILTER_BANDPASS);
+    DefineConstant(filter, notch, FILTER_NOTCH);
+    DefineConstant(filter, peaking, FILTER_PEAKING);
+    DefineConstant(filter, lowshelf, FILTER_LOWSHELF);
+    DefineConstant(filter, highshelf, FILTER_HIGHSHELF);
+
+    AddEmptyObject(cfn, overflow);
+    DefineConstant(overflow, drop_newest, OVERFLOW_DROP_NEWEST);
+    DefineConstant(overflow, drop_oldest, OVERFLOW_DROP_OLDEST);
+
+    AddEmptyObject(cfn, sync);
+    DefineConstant(sync, none, RECORDER_SYNC_NONE);
+    DefineConstant(sync, close, RECORDER_SYNC_CLOSE);
+    DefineConstant(sync, periodic, RECORDER_SYNC_PERIODIC);
+
     AddEmptyObject(cfn, state);
     DefineConstant(state, unconnected, PA_STREAM_UNCONNECTED);
     DefineConstant(state, creating, PA_STREAM_CREATING);
@@ -377,7 +1512,7 @@ namespace pulse {
 
     JS_ASSERT(args.IsConstructCall());
 
-    JS_ASSERT(args.Length() == 8);
+    JS_ASSERT(args.Length() == 10);
     JS_ASSERT(args[0]->IsObject());
     JS_ASSERT(args[6]->IsObject());
 
@@ -403,6 +1538,69 @@ namespace pulse {
       ss.channels = uint8_t(Nan::To<uint32_t>(args[3]).FromJust());
     }
 
+    /* a layout name (e.g. surround-51) or a list of positions */
+    pa_channel_map map;
+    bool has_map = false;
+    if (args[8]->IsString()) {
+      Nan::Utf8String map_name(args[8]);
+      if (!pa_channel_map_parse(&map, *map_name)) {
+        RET_ERROR(TypeError, "Invalid channel map.");
+      }
+      if (!args[3]->IsUint32())
+        ss.channels = map.channels;
+      if (!pa_channel_map_compatible(&map, &ss)) {
+        RET_ERROR(RangeError, "Channel map does not match the number of channels.");
+      }
+      has_map = true;
+    }
+
+    /* candidate formats, for passthrough: strings as printed by
+       pa_format_info_snprint, or { encoding, format, rate, channels } */
+    std::vector<pa_format_info*> formats;
+    if (args[9]->IsArray()) {
+      v8::Local<v8::Array> list = args[9].As<v8::Array>();
+      for (uint32_t i = 0; i < list->Length(); i++) {
+        v8::Local<v8::Value> item = Nan::Get(list, i).ToLocalChecked();
+        pa_format_info *f = NULL;
+
+        if (item->IsString()) {
+          Nan::Utf8String str(item);
+          f = pa_format_info_from_string(*str);
+        } else if (item->IsObject()) {
+          v8::Local<v8::Object> obj = item.As<v8::Object>();
+          v8::Local<v8::Value> encoding = Nan::Get(obj, Nan::New("encoding").ToLocalChecked()).ToLocalChecked();
+          v8::Local<v8::Value> format = Nan::Get(obj, Nan::New("format").ToLocalChecked()).ToLocalChecked();
+          v8::Local<v8::Value> rate = Nan::Get(obj, Nan::New("rate").ToLocalChecked()).ToLocalChecked();
+          v8::Local<v8::Value> channels = Nan::Get(obj, Nan::New("channels").ToLocalChecked()).ToLocalChecked();
+
+          f = pa_format_info_new();
+          f->encoding = encoding->IsUint32() ? pa_encoding_t(Nan::To<uint32_t>(encoding).FromJust()) : PA_ENCODING_INVALID;
+          if (format->IsUint32())
+            pa_format_info_set_sample_format(f, pa_sample_format_t(Nan::To<uint32_t>(format).FromJust()));
+          if (rate->IsUint32())
+            pa_format_info_set_rate(f, Nan::To<uint32_t>(rate).FromJust());
+          if (channels->IsUint32())
+            pa_format_info_set_channels(f, Nan::To<uint32_t>(channels).FromJust());
+        }
+
+        if (f && !pa_format_info_valid(f)) {
+          pa_format_info_free(f);
+          f = NULL;
+        }
+        if (!f) {
+          for (pa_format_info *g : formats)
+            pa_format_info_free(g);
+          RET_ERROR(TypeError, "Invalid stream format.");
+        }
+        formats.push_back(f);
+      }
+
+      /* until the server picks one, assume the first */
+      pa_sample_spec first;
+      if (!formats.empty() && pa_format_info_to_sample_spec(formats[0], &first, NULL) >= 0)
+        ss = first;
+    }
+
     pa_usec_t latency = 0;
     if (args[4]->IsUint32()) {
       latency = pa_usec_t(Nan::To<uint32_t>(args[4]).FromJust());
@@ -415,7 +1613,10 @@ namespace pulse {
     auto props = maybe_build_proplist(args[6].As<v8::Object>());
 
     /* initialize instance */
-    Stream *stm = new Stream(isolate, *ctx, stream_name.get(), &ss, latency, props.get());
+    Stream *stm = new Stream(isolate, *ctx, stream_name.get(), &ss, has_map ? &map : NULL,
+                             formats.data(), unsigned(formats.size()), latency, props.get());
+    for (pa_format_info *f : formats)
+      pa_format_info_free(f);
 
     if (!stm->pa_stm) {
       delete stm;
@@ -432,7 +1633,7 @@ namespace pulse {
 
   void
   Stream::Connect(const Nan::FunctionCallbackInfo<v8::Value>& args) {
-    JS_ASSERT(args.Length() == 3);
+    JS_ASSERT(args.Length() == 3 || args.Length() == 4);
 
     Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
     JS_ASSERT(stm);
@@ -452,7 +1653,14 @@ namespace pulse {
       sf = pa_stream_flags_t(Nan::To<uint32_t>(args[2]).FromJust());
     }
 
-    int status = stm->connect(device_name.get(), sd, sf);
+    Stream *sync_stream = NULL;
+    if (args.Length() > 3 && args[3]->IsObject()) {
+      sync_stream = ObjectWrap::Unwrap<Stream>(args[3].As<v8::Object>());
+      JS_ASSERT(sync_stream);
+      JS_ASSERT(sd == PA_STREAM_PLAYBACK);
+    }
+
+    int status = stm->connect(device_name.get(), sd, sf, sync_stream);
     PA_ASSERT(status);
 
     args.GetReturnValue().SetUndefined();
@@ -468,6 +1676,64 @@ namespace pulse {
     args.GetReturnValue().SetUndefined();
   }
 
+  /* record a single sink input instead of the whole monitor source; the
+     stream is then connected to the monitor of the sink it plays on */
+  void
+  Stream::Monitor(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 1);
+    JS_ASSERT(args[0]->IsUint32());
+
+    if (pa_stream_get_state(stm->pa_stm) != PA_STREAM_UNCONNECTED) {
+      RET_ERROR(Error, "The monitored stream must be set before connecting.");
+    }
+
+    PA_ASSERT(pa_stream_set_monitor_stream(stm->pa_stm, Nan::To<uint32_t>(args[0]).FromJust()));
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::Events(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 1);
+
+    if (args[0]->IsFunction())
+      stm->event_callback = Nan::Global<v8::Function>(args[0].As<v8::Function>());
+    else
+      stm->event_callback.Reset();
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::Cork(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 2);
+    JS_ASSERT(args[1]->IsFunction());
+
+    if (stm->pa_state != PA_STREAM_READY) {
+      RET_ERROR(Error, "Stream is not ready.");
+    }
+
+    stm->user_corked = Nan::To<bool>(args[0]).FromJust();
+    if (!stm->user_corked)
+      stm->wake();
+
+    Pending *p = new Pending(args.GetIsolate(), args.This(), args[1].As<v8::Function>());
+    pa_operation *op = pa_stream_cork(stm->pa_stm, stm->user_corked, StreamSuccessCallback, p);
+    if (!op) {
+      delete p;
+      RET_ERROR(Error, pa_strerror(pa_context_errno(stm->ctx.pa_ctx)));
+    }
+    pa_operation_unref(op);
+
+    args.GetReturnValue().SetUndefined();
+  }
+
   void
   Stream::Latency(const Nan::FunctionCallbackInfo<v8::Value>& args) {
     Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
@@ -478,7 +1744,75 @@ namespace pulse {
 
     PA_ASSERT(pa_stream_get_latency(stm->pa_stm, &latency, &negative));
 
-    args.GetReturnValue().Set(Nan::New(uint32_t(latency)));
+    args.GetReturnValue().Set(Nan::New(negative ? -double(latency) : double(latency)));
+  }
+
+  void
+  Stream::Time(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    pa_usec_t usec;
+
+    PA_ASSERT(pa_stream_get_time(stm->pa_stm, &usec));
+
+    args.GetReturnValue().Set(Nan::New(double(usec)));
+  }
+
+  void
+  Stream::Clock(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    args.GetReturnValue().Set(Nan::New(stm->clock()));
+  }
+
+  void
+  Stream::Timing(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    const pa_timing_info *ti = pa_stream_get_timing_info(stm->pa_stm);
+    if (!ti) {
+      args.GetReturnValue().SetNull();
+      return;
+    }
+
+    auto info = Nan::New<v8::Object>();
+
+    Nan::Set(info, Nan::New("timestamp").ToLocalChecked(), Nan::New(double(pa_timeval_load(&ti->timestamp))));
+    Nan::Set(info, Nan::New("synchronized_clocks").ToLocalChecked(), Nan::New(bool(ti->synchronized_clocks)));
+    Nan::Set(info, Nan::New("sink_usec").ToLocalChecked(), Nan::New(double(ti->sink_usec)));
+    Nan::Set(info, Nan::New("source_usec").ToLocalChecked(), Nan::New(double(ti->source_usec)));
+    Nan::Set(info, Nan::New("transport_usec").ToLocalChecked(), Nan::New(double(ti->transport_usec)));
+    Nan::Set(info, Nan::New("playing").ToLocalChecked(), Nan::New(bool(ti->playing)));
+    Nan::Set(info, Nan::New("write_index_corrupt").ToLocalChecked(), Nan::New(bool(ti->write_index_corrupt)));
+    Nan::Set(info, Nan::New("write_index").ToLocalChecked(), Nan::New(double(ti->write_index)));
+    Nan::Set(info, Nan::New("read_index_corrupt").ToLocalChecked(), Nan::New(bool(ti->read_index_corrupt)));
+    Nan::Set(info, Nan::New("read_index").ToLocalChecked(), Nan::New(double(ti->read_index)));
+    Nan::Set(info, Nan::New("configured_sink_usec").ToLocalChecked(), Nan::New(double(ti->configured_sink_usec)));
+    Nan::Set(info, Nan::New("configured_source_usec").ToLocalChecked(), Nan::New(double(ti->configured_source_usec)));
+    Nan::Set(info, Nan::New("since_underrun").ToLocalChecked(), Nan::New(double(ti->since_underrun)));
+
+    args.GetReturnValue().Set(info);
+  }
+
+  void
+  Stream::UpdateTiming(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 1);
+    JS_ASSERT(args[0]->IsFunction());
+
+    Pending *p = new Pending(args.GetIsolate(), args.This(), args[0].As<v8::Function>());
+    pa_operation *op = pa_stream_update_timing_info(stm->pa_stm, StreamSuccessCallback, p);
+    if (!op) {
+      delete p;
+      RET_ERROR(Error, pa_strerror(pa_context_errno(stm->ctx.pa_ctx)));
+    }
+    pa_operation_unref(op);
+
+    args.GetReturnValue().SetUndefined();
   }
 
   void
@@ -502,4 +1836,712 @@ namespace pulse {
 
     args.GetReturnValue().SetUndefined();
   }
+
+  void
+  Stream::Link(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 3 || args.Length() == 4);
+    JS_ASSERT(args[1]->IsNumber());
+    JS_ASSERT(args[2]->IsUint32());
+
+    if (!args[0]->IsObject()) {
+      stm->link(NULL, v8::Local<v8::Object>(), 1.0f, 0, 0);
+      args.GetReturnValue().SetUndefined();
+      return;
+    }
+
+    v8::Local<v8::Object> target_object;
+    if (!Nan::To<v8::Object>(args[0]).ToLocal(&target_object))
+      return;
+    Stream *target = ObjectWrap::Unwrap<Stream>(target_object);
+    JS_ASSERT(target);
+    JS_ASSERT(target != stm);
+
+    if (stm->direction != PA_STREAM_RECORD || target->direction != PA_STREAM_PLAYBACK) {
+      RET_ERROR(Error, "A link goes from a record stream to a playback stream.");
+    }
+    if (stm->pa_ss.rate != target->pa_ss.rate) {
+      RET_ERROR(Error, "Linked streams must have the same sample rate.");
+    }
+
+    float gain = float(Nan::To<double>(args[1]).FromJust());
+    bool convert = stm->pa_ss.format != target->pa_ss.format || stm->pa_ss.channels != target->pa_ss.channels || gain != 1.0f;
+    if (convert && (!stm->processable() || !target->processable())) {
+      RET_ERROR(Error, "Sample format not supported by native processing.");
+    }
+
+    double drift_ppm = args.Length() > 3 && args[3]->IsNumber() ? Nan::To<double>(args[3]).FromJust() : 0;
+    if (drift_ppm > 0 && !(target->flags & PA_STREAM_VARIABLE_RATE)) {
+      RET_ERROR(Error, "Drift compensation needs a playback stream with the variable_rate flag.");
+    }
+
+    stm->link(target, target_object, gain, pa_usec_t(Nan::To<uint32_t>(args[2]).FromJust()), drift_ppm);
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::Replace(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    stm->replace();
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::Trigger(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 1);
+    JS_ASSERT(args[0]->IsFunction());
+
+    Pending *p = new Pending(args.GetIsolate(), args.This(), args[0].As<v8::Function>());
+    pa_operation *op = pa_stream_trigger(stm->pa_stm, StreamSuccessCallback, p);
+    if (!op) {
+      delete p;
+      RET_ERROR(Error, pa_strerror(pa_context_errno(stm->ctx.pa_ctx)));
+    }
+    pa_operation_unref(op);
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::SetGain(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 4);
+    JS_ASSERT(args[0]->IsNumber());
+    JS_ASSERT(args[1]->IsUint32());
+    JS_ASSERT(args[2]->IsUint32());
+    JS_ASSERT(args[3]->IsUint32());
+
+    if (!stm->processable()) {
+      RET_ERROR(Error, "Sample format not supported by native processing.");
+    }
+
+    stm->gain.schedule(float(Nan::To<double>(args[0]).FromJust()),
+                       Nan::To<uint32_t>(args[1]).FromJust(),
+                       GainCurve(Nan::To<uint32_t>(args[2]).FromJust()),
+                       Nan::To<uint32_t>(args[3]).FromJust());
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::Memory(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    auto info = Nan::New<v8::Object>();
+    Nan::Set(info, Nan::New("native").ToLocalChecked(), Nan::New(double(stm->memory)));
+    Nan::Set(info, Nan::New("queued").ToLocalChecked(), Nan::New(double(stm->queued)));
+
+    args.GetReturnValue().Set(info);
+  }
+
+  void
+  Stream::Index(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    /* the sink input or source output index, to move the stream with */
+    uint32_t index = pa_stream_get_state(stm->pa_stm) == PA_STREAM_READY ? pa_stream_get_index(stm->pa_stm) : PA_INVALID_INDEX;
+    if (index == PA_INVALID_INDEX) {
+      args.GetReturnValue().SetNull();
+      return;
+    }
+
+    args.GetReturnValue().Set(Nan::New(index));
+  }
+
+  void
+  Stream::Device(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    if (pa_stream_get_state(stm->pa_stm) != PA_STREAM_READY || stm->direction == PA_STREAM_UPLOAD) {
+      args.GetReturnValue().SetNull();
+      return;
+    }
+
+    auto info = Nan::New<v8::Object>();
+    Nan::Set(info, Nan::New("name").ToLocalChecked(), Nan::New(pa_stream_get_device_name(stm->pa_stm)).ToLocalChecked());
+    Nan::Set(info, Nan::New("index").ToLocalChecked(), Nan::New(pa_stream_get_device_index(stm->pa_stm)));
+
+    args.GetReturnValue().Set(info);
+  }
+
+  void
+  Stream::FormatInfo(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    const pa_format_info *f = pa_stream_get_state(stm->pa_stm) == PA_STREAM_READY ? pa_stream_get_format_info(stm->pa_stm) : NULL;
+    if (!f) {
+      args.GetReturnValue().SetNull();
+      return;
+    }
+
+    char str[PA_FORMAT_INFO_SNPRINT_MAX];
+    uint32_t rate;
+    uint8_t channels;
+    auto info = Nan::New<v8::Object>();
+
+    Nan::Set(info, Nan::New("encoding").ToLocalChecked(), Nan::New(f->encoding));
+    if (pa_format_info_get_rate(f, &rate) >= 0)
+      Nan::Set(info, Nan::New("rate").ToLocalChecked(), Nan::New(rate));
+    if (pa_format_info_get_channels(f, &channels) >= 0)
+      Nan::Set(info, Nan::New("channels").ToLocalChecked(), Nan::New(uint32_t(channels)));
+    Nan::Set(info, Nan::New("description").ToLocalChecked(), Nan::New(pa_format_info_snprint(str, sizeof(str), f)).ToLocalChecked());
+
+    args.GetReturnValue().Set(info);
+  }
+
+  void
+  Stream::SetRemix(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    if (args.Length() == 1 && args[0]->IsNull()) {
+      stm->remix.reset();
+      args.GetReturnValue().SetUndefined();
+      return;
+    }
+
+    JS_ASSERT(args.Length() == 2);
+    JS_ASSERT(args[0]->IsUint32());
+    JS_ASSERT(args[1]->IsArray());
+
+    if (!stm->processable()) {
+      RET_ERROR(Error, "Sample format not supported by native processing.");
+    }
+
+    uint32_t channels = Nan::To<uint32_t>(args[0]).FromJust();
+    if (!channels || channels > PA_CHANNELS_MAX) {
+      RET_ERROR(RangeError, "Invalid number of channels.");
+    }
+
+    /* playback streams mix what is written into the stream channels,
+       record streams mix the stream channels into what JS gets */
+    bool playback = stm->direction != PA_STREAM_RECORD;
+    unsigned in = playback ? channels : stm->pa_ss.channels;
+    unsigned out = playback ? stm->pa_ss.channels : channels;
+
+    if (!playback && stm->vad) {
+      RET_ERROR(Error, "Remixing does not apply to voice activity detection.");
+    }
+
+    v8::Local<v8::Array> list = args[1].As<v8::Array>();
+    if (list->Length() != in * out) {
+      RET_ERROR(RangeError, "The matrix needs one gain per output and input channel.");
+    }
+
+    std::vector<float> matrix(in * out);
+    for (uint32_t i = 0; i < in * out; i++)
+      matrix[i] = float(Nan::To<double>(Nan::Get(list, i).ToLocalChecked()).FromMaybe(0));
+
+    stm->remix.reset(new Remix(in, out, matrix));
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::SetEq(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 5);
+    JS_ASSERT(args[0]->IsUint32());
+    JS_ASSERT(args[1]->IsUint32());
+    JS_ASSERT(args[2]->IsNumber());
+    JS_ASSERT(args[3]->IsNumber());
+    JS_ASSERT(args[4]->IsNumber());
+
+    if (!stm->processable()) {
+      RET_ERROR(Error, "Sample format not supported by native processing.");
+    }
+
+    uint32_t type = Nan::To<uint32_t>(args[1]).FromJust();
+    if (type > FILTER_HIGHSHELF) {
+      RET_ERROR(RangeError, "Invalid filter type.");
+    }
+
+    if (!stm->eq)
+      stm->eq.reset(new Equalizer(stm->pa_ss.rate, stm->pa_ss.channels));
+    if (!stm->eq->set(Nan::To<uint32_t>(args[0]).FromJust(), FilterType(type),
+                      Nan::To<double>(args[2]).FromJust(),
+                      Nan::To<double>(args[3]).FromJust(),
+                      Nan::To<double>(args[4]).FromJust())) {
+      RET_ERROR(RangeError, "Invalid filter index, frequency or Q.");
+    }
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::TruncateEq(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 1);
+    JS_ASSERT(args[0]->IsUint32());
+
+    if (stm->eq)
+      stm->eq->truncate(Nan::To<uint32_t>(args[0]).FromJust());
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::SetVad(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    if (args.Length() == 1 && args[0]->IsNull()) {
+      stm->vad.reset();
+      args.GetReturnValue().SetUndefined();
+      return;
+    }
+
+    JS_ASSERT(args.Length() == 5);
+    JS_ASSERT(args[0]->IsNumber());
+    JS_ASSERT(args[1]->IsNumber());
+    JS_ASSERT(args[2]->IsNumber());
+    JS_ASSERT(args[3]->IsUint32());
+    JS_ASSERT(args[4]->IsUint32());
+
+    if (!stm->processable()) {
+      RET_ERROR(Error, "Sample format not supported by native processing.");
+    }
+    if (stm->remix && stm->direction == PA_STREAM_RECORD) {
+      RET_ERROR(Error, "Remixing does not apply to voice activity detection.");
+    }
+
+    stm->vad.reset(new Vad(stm->pa_ss,
+                           float(Nan::To<double>(args[0]).FromJust()),
+                           float(Nan::To<double>(args[1]).FromJust()),
+                           float(Nan::To<double>(args[2]).FromJust()),
+                           Nan::To<uint32_t>(args[3]).FromJust(),
+                           Nan::To<uint32_t>(args[4]).FromJust()));
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::SetAnalyser(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    if (args.Length() == 1 && args[0]->IsNull()) {
+      stm->analyser.reset();
+      stm->analyser_output.Reset();
+      stm->account_analyser();
+      stm->update_cork();
+      args.GetReturnValue().SetUndefined();
+      return;
+    }
+
+    JS_ASSERT(args.Length() == 5);
+    JS_ASSERT(args[0]->IsUint32());
+    JS_ASSERT(args[1]->IsUint32());
+    JS_ASSERT(args[2]->IsUint32());
+    JS_ASSERT(args[3]->IsBoolean());
+    JS_ASSERT(args[4]->IsFloat32Array());
+
+    size_t size = Nan::To<uint32_t>(args[0]).FromJust();
+    size_t bands = Nan::To<uint32_t>(args[2]).FromJust();
+
+    if (stm->direction != PA_STREAM_RECORD) {
+      RET_ERROR(Error, "Only record streams can be analysed.");
+    }
+    if (!stm->processable()) {
+      RET_ERROR(Error, "Sample format not supported by native processing.");
+    }
+    if (!Analyser::valid_size(size)) {
+      RET_ERROR(RangeError, "Analyser size must be a power of two, from 4 to 65536.");
+    }
+    if (bands > size / 2) {
+      RET_ERROR(RangeError, "More bands than frequency bins.");
+    }
+
+    std::unique_ptr<Analyser> analyser(new Analyser(stm->pa_ss, size, Nan::To<uint32_t>(args[1]).FromJust(), bands,
+                                                    Nan::To<bool>(args[3]).FromJust()));
+    if (Nan::TypedArrayContents<float>(args[4]).length() < analyser->length()) {
+      RET_ERROR(RangeError, "Spectrum array too short.");
+    }
+
+    stm->analyser = std::move(analyser);
+    stm->analyser_output = Nan::Global<v8::Float32Array>(args[4].As<v8::Float32Array>());
+    stm->account_analyser();
+    stm->update_cork();
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::SetAdaptive(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    if (args.Length() == 1 && args[0]->IsNull()) {
+      stm->adaptive.reset();
+      args.GetReturnValue().SetUndefined();
+      return;
+    }
+
+    JS_ASSERT(args.Length() == 3);
+    JS_ASSERT(args[0]->IsUint32());
+    JS_ASSERT(args[1]->IsUint32());
+    JS_ASSERT(args[2]->IsUint32());
+
+    if (stm->direction != PA_STREAM_PLAYBACK || stm->pa_state != PA_STREAM_READY) {
+      RET_ERROR(Error, "Stream is not a ready playback stream.");
+    }
+
+    /* start from the latency the server settled on */
+    const pa_buffer_attr *ba = pa_stream_get_buffer_attr(stm->pa_stm);
+    pa_usec_t current = ba ? pa_bytes_to_usec(ba->tlength, &stm->pa_ss) : stm->latency;
+
+    stm->adaptive.reset(new AdaptiveLatency(Nan::To<uint32_t>(args[0]).FromJust(),
+                                            Nan::To<uint32_t>(args[1]).FromJust(),
+                                            Nan::To<uint32_t>(args[2]).FromJust(),
+                                            current, double(uv_hrtime()) / 1000.0));
+    stm->adaptive_applied = current;
+    stm->adapt();
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::UpdateRate(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 2);
+    JS_ASSERT(args[0]->IsUint32());
+    JS_ASSERT(args[1]->IsFunction());
+
+    if (!(stm->flags & PA_STREAM_VARIABLE_RATE)) {
+      RET_ERROR(Error, "Stream was not connected with the variable_rate flag.");
+    }
+
+    /* along with the drift compensation of a link, if any: the rate is
+       only taken as current once the server applied it */
+    stm->rate_waiting.emplace_back(new Pending(args.GetIsolate(), args.This(), args[1].As<v8::Function>()));
+    stm->update_rate(Nan::To<uint32_t>(args[0]).FromJust());
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::SetIdle(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    if (args.Length() == 1 && args[0]->IsNull()) {
+      stm->idle(0, false);
+      args.GetReturnValue().SetUndefined();
+      return;
+    }
+
+    JS_ASSERT(args.Length() == 2);
+    JS_ASSERT(args[0]->IsUint32());
+
+    if (stm->direction != PA_STREAM_PLAYBACK) {
+      RET_ERROR(Error, "Only playback streams go idle.");
+    }
+
+    uint32_t timeout = Nan::To<uint32_t>(args[0]).FromJust();
+    if (!timeout) {
+      RET_ERROR(RangeError, "Invalid idle timeout.");
+    }
+
+    stm->idle(timeout, Nan::To<bool>(args[1]).FromJust());
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::SetJitter(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    if (args.Length() == 1 && args[0]->IsNull()) {
+      stm->jitter.reset();
+      stm->account_jitter();
+      args.GetReturnValue().SetUndefined();
+      return;
+    }
+
+    JS_ASSERT(args.Length() == 2);
+    JS_ASSERT(args[0]->IsUint32());
+    JS_ASSERT(args[1]->IsUint32());
+
+    if (stm->direction != PA_STREAM_PLAYBACK || stm->pa_state != PA_STREAM_READY) {
+      RET_ERROR(Error, "Stream is not a ready playback stream.");
+    }
+    if (stm->encoded) {
+      RET_ERROR(Error, "Jitter buffer needs a PCM stream.");
+    }
+
+    /* packets replace whatever was being played */
+    if (!stm->write_buffer.IsEmpty()) {
+      stm->flush(NULL, NULL);
+      stm->drain();
+    }
+    stm->file.reset();
+    stm->jitter.reset(new JitterBuffer(stm->pa_ss,
+                                       Nan::To<uint32_t>(args[0]).FromJust(),
+                                       Nan::To<uint32_t>(args[1]).FromJust()));
+    stm->account_jitter();
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::Packet(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 2);
+    JS_ASSERT(args[0]->IsUint32());
+    JS_ASSERT(node::Buffer::HasInstance(args[1]));
+
+    if (!stm->jitter) {
+      RET_ERROR(Error, "Jitter buffer is not enabled.");
+    }
+
+    if (stm->ctx.over_budget(node::Buffer::Length(args[1]))) {
+      stm->jitter->refused++;
+    } else {
+      stm->jitter->push(Nan::To<uint32_t>(args[0]).FromJust(),
+                        node::Buffer::Data(args[1]), node::Buffer::Length(args[1]),
+                        double(uv_hrtime()) / 1000.0);
+      stm->account_jitter();
+    }
+
+    stm->wake();
+    if (pa_stream_is_corked(stm->pa_stm) && !stm->user_corked)
+      pa_stream_cork(stm->pa_stm, 0, NULL, NULL);
+
+    /* the server may be waiting on us since the buffer ran dry */
+    size_t length = pa_stream_writable_size(stm->pa_stm);
+    if (length > 0 && length != size_t(-1))
+      stm->jitter_request(length);
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::JitterStats(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    if (!stm->jitter) {
+      args.GetReturnValue().SetNull();
+      return;
+    }
+
+    JitterBuffer& jb = *stm->jitter;
+    size_t frame_size = pa_frame_size(&stm->pa_ss);
+    auto info = Nan::New<v8::Object>();
+
+    Nan::Set(info, Nan::New("depth").ToLocalChecked(), Nan::New(double(pa_bytes_to_usec(jb.depth() * frame_size, &stm->pa_ss))));
+    Nan::Set(info, Nan::New("target").ToLocalChecked(), Nan::New(double(pa_bytes_to_usec(jb.target() * frame_size, &stm->pa_ss))));
+    Nan::Set(info, Nan::New("jitter").ToLocalChecked(), Nan::New(jb.jitter_frames() * 1e6 / stm->pa_ss.rate));
+    Nan::Set(info, Nan::New("received").ToLocalChecked(), Nan::New(double(jb.received)));
+    Nan::Set(info, Nan::New("late").ToLocalChecked(), Nan::New(double(jb.late)));
+    Nan::Set(info, Nan::New("concealed").ToLocalChecked(), Nan::New(double(jb.lost)));
+    Nan::Set(info, Nan::New("skipped").ToLocalChecked(), Nan::New(double(jb.skipped)));
+    Nan::Set(info, Nan::New("refused").ToLocalChecked(), Nan::New(double(jb.refused)));
+
+    args.GetReturnValue().Set(info);
+  }
+
+  void
+  Stream::Subscribe(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 3);
+    JS_ASSERT(args[0]->IsFunction());
+    JS_ASSERT(args[1]->IsUint32());
+    JS_ASSERT(args[2]->IsUint32());
+
+    if (stm->direction != PA_STREAM_RECORD) {
+      RET_ERROR(Error, "Only record streams can be subscribed to.");
+    }
+
+    std::unique_ptr<Subscriber> sub(new Subscriber());
+    sub->callback.Reset(args[0].As<v8::Function>());
+    sub->queued = 0;
+    sub->limit = Nan::To<uint32_t>(args[1]).FromJust();
+    sub->policy = OverflowPolicy(Nan::To<uint32_t>(args[2]).FromJust());
+    sub->paused = false;
+    sub->dropped = 0;
+
+    uint32_t id = stm->next_subscriber++;
+    stm->subscribers[id] = std::move(sub);
+    stm->update_cork();
+
+    args.GetReturnValue().Set(Nan::New(id));
+  }
+
+  void
+  Stream::Unsubscribe(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 1);
+    JS_ASSERT(args[0]->IsUint32());
+
+    auto it = stm->subscribers.find(Nan::To<uint32_t>(args[0]).FromJust());
+    if (it != stm->subscribers.end()) {
+      stm->account(0, -int64_t(it->second->queued));
+      stm->subscribers.erase(it);
+    }
+    stm->update_cork();
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::ResumeSubscriber(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 1);
+    JS_ASSERT(args[0]->IsUint32());
+
+    uint32_t id = Nan::To<uint32_t>(args[0]).FromJust();
+    auto it = stm->subscribers.find(id);
+    if (it != stm->subscribers.end() && it->second->paused) {
+      it->second->paused = false;
+      stm->flush_subscriber(id);
+    }
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::SubscriberStats(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 1);
+    JS_ASSERT(args[0]->IsUint32());
+
+    auto it = stm->subscribers.find(Nan::To<uint32_t>(args[0]).FromJust());
+    if (it == stm->subscribers.end()) {
+      args.GetReturnValue().SetNull();
+      return;
+    }
+
+    auto info = Nan::New<v8::Object>();
+    Nan::Set(info, Nan::New("queued").ToLocalChecked(), Nan::New(double(it->second->queued)));
+    Nan::Set(info, Nan::New("dropped").ToLocalChecked(), Nan::New(double(it->second->dropped)));
+
+    args.GetReturnValue().Set(info);
+  }
+
+  void
+  Stream::Record(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    if (args.Length() == 1 && args[0]->IsNull()) {
+      stm->record(NULL);
+      args.GetReturnValue().SetUndefined();
+      return;
+    }
+
+    JS_ASSERT(args.Length() == 5);
+    JS_ASSERT(args[0]->IsString());
+    JS_ASSERT(args[2]->IsUint32());
+    JS_ASSERT(args[3]->IsUint32());
+    JS_ASSERT(args[4]->IsUint32());
+
+    if (stm->direction != PA_STREAM_RECORD) {
+      RET_ERROR(Error, "Only record streams can be recorded.");
+    }
+
+    bool wav = Nan::To<bool>(args[1]).FromJust();
+    if (wav && !recorder_format_supported(stm->pa_ss.format)) {
+      RET_ERROR(Error, "Sample format cannot be stored in a WAV file.");
+    }
+
+    Nan::Utf8String path(args[0]);
+    std::unique_ptr<Recorder> r(new Recorder(stm->pa_ss, wav,
+                                             RecorderSync(Nan::To<uint32_t>(args[2]).FromJust()),
+                                             Nan::To<uint32_t>(args[3]).FromJust(),
+                                             Nan::To<uint32_t>(args[4]).FromJust(),
+                                             RecorderCallback, stm));
+
+    if (stm->ctx.over_budget(r->buffer_size())) {
+      RET_ERROR(Error, "Memory budget exceeded.");
+    }
+
+    const char *err = r->start(*path);
+    if (err) {
+      RET_ERROR(Error, err);
+    }
+    stm->record(r.release());
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::Play(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 2);
+    JS_ASSERT(args[0]->IsString());
+
+    if (stm->direction != PA_STREAM_PLAYBACK || stm->pa_state != PA_STREAM_READY) {
+      RET_ERROR(Error, "Stream is not a ready playback stream.");
+    }
+
+    Nan::Utf8String path(args[0]);
+    std::unique_ptr<FileSource> source(new FileSource());
+
+    const char *err = source->open(*path, stm->pa_ss);
+    if (err) {
+      RET_ERROR(Error, err);
+    }
+    if (!pa_sample_spec_equal(&source->ss, &stm->pa_ss)) {
+      RET_ERROR(Error, "File sample spec does not match the stream.");
+    }
+    source->loop = Nan::To<bool>(args[1]).FromJust();
+
+    size_t frames = source->frames();
+    stm->play(source.release());
+
+    args.GetReturnValue().Set(Nan::New(double(frames)));
+  }
+
+  void
+  Stream::Seek(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+    JS_ASSERT(args.Length() == 1);
+    JS_ASSERT(args[0]->IsNumber());
+
+    if (!stm->file) {
+      RET_ERROR(Error, "No file is playing.");
+    }
+
+    double frame = Nan::To<double>(args[0]).FromJust();
+    stm->file->seek(frame > 0 ? size_t(frame) : 0);
+
+    /* drop what was queued from the old position, the server asks for more */
+    stm->flush(NULL, NULL);
+
+    args.GetReturnValue().SetUndefined();
+  }
+
+  void
+  Stream::Stop(const Nan::FunctionCallbackInfo<v8::Value>& args) {
+    Stream *stm = ObjectWrap::Unwrap<Stream>(args.This());
+    JS_ASSERT(stm);
+
+    stm->stop();
+
+    args.GetReturnValue().SetUndefined();
+  }
 }
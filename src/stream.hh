@@ -22,8 +22,28 @@
 
 #include "common.hh"
 #include "context.hh"
+#include "adaptive-latency.hh"
+#include "drift.hh"
+#include "file-source.hh"
+#include "jitter.hh"
+#include "recorder.hh"
+#include "sample.hh"
+#include "gain.hh"
+#include "biquad.hh"
+#include "remix.hh"
+#include "vad.hh"
+#include "analyser.hh"
+
+#include <deque>
+#include <map>
+#include <vector>
 
 namespace pulse {
+  enum OverflowPolicy {
+    OVERFLOW_DROP_NEWEST,
+    OVERFLOW_DROP_OLDEST,
+  };
+
   class Stream: public Nan::ObjectWrap {
   private:
     v8::Isolate *isolate;
@@ -31,11 +51,32 @@ namespace pulse {
     pa_sample_spec pa_ss;
     pa_stream *pa_stm;
     
-    Stream(v8::Isolate *isolate, Context& context, Nan::Utf8String *stream_name, const pa_sample_spec *sample_spec, pa_usec_t initial_latency, pa_proplist* props);
+    Stream(v8::Isolate *isolate, Context& context, Nan::Utf8String *stream_name, const pa_sample_spec *sample_spec, const pa_channel_map *channel_map,
+           pa_format_info *const *formats, unsigned n_formats, pa_usec_t initial_latency, pa_proplist* props);
+
+    /* created from a list of formats, possibly encoded (passthrough):
+       pa_ss follows the negotiated format once connected, and native
+       processing only applies to PCM */
+    bool extended;
+    bool encoded;
+    bool processable() const {
+      return !encoded && sample_format_supported(pa_ss.format);
+    }
     ~Stream();
 
     static void BufferAttrCallback(pa_stream *s, void *ud);
     static void LatencyCallback(pa_stream *s, void *ud);
+
+    /* clock, interpolated locally between timing updates */
+    double clock_usec;
+    double clock_at;
+    double clock_last;
+    bool clock_running;
+    /* without auto timing updates, clock() asks for one itself */
+    bool clock_updating;
+    static void ClockCallback(pa_stream *s, int success, void *ud);
+    double clock();
+    void clock_reset();
     
     /* state */
     Nan::Global<v8::Function> state_callback;
@@ -43,15 +84,83 @@ namespace pulse {
     static void StateCallback(pa_stream *s, void *ud);
     void state_listener(v8::Local<v8::Value> callback);
     
+    /* events */
+    Nan::Global<v8::Function> event_callback;
+    void emit(const char *name, int argc = 0, v8::Local<v8::Value> *argv = NULL);
+
     /* connection */
-    int connect(Nan::Utf8String *device_name, pa_stream_direction_t direction, pa_stream_flags_t flags);
+    pa_stream_direction_t direction;
+    pa_stream_flags_t flags;
+    int connect(Nan::Utf8String *device_name, pa_stream_direction_t direction, pa_stream_flags_t flags, Stream *sync_stream);
     void disconnect();
 
+    /* the server moved the stream to another sink or source */
+    static void MovedCallback(pa_stream *s, void *ud);
+
+    /* corking, a stream corked on purpose is not uncorked by writes */
+    bool user_corked;
+    static void StartedCallback(pa_stream *s, void *ud);
+
     /* read */
     Nan::Global<v8::Function> read_callback;
     static void ReadCallback(pa_stream *s, size_t nb, void *ud);
     void data();
     void read(v8::Local<v8::Value> callback);
+    void deliver(v8::Local<v8::Object> buffer);
+    bool capturing() const;
+    void update_cork();
+
+    /* more JS consumers of the captured audio, all handed the same chunks,
+       which they must not modify; each one pauses by returning false and
+       queues up to its limit before dropping */
+    struct Subscriber {
+      Nan::Global<v8::Function> callback;
+      std::deque<Nan::Global<v8::Object>> queue;
+      size_t queued;  /* bytes */
+      size_t limit;   /* bytes */
+      OverflowPolicy policy;
+      bool paused;
+      uint64_t dropped; /* frames */
+    };
+    std::map<uint32_t, std::unique_ptr<Subscriber>> subscribers;
+    uint32_t next_subscriber;
+
+    void publish(v8::Local<v8::Object> chunk);
+    void flush_subscriber(uint32_t id);
+
+    /* voice activity detection on the captured audio, gates the processed
+       chunks delivered to JS */
+    std::unique_ptr<Vad> vad;
+    void gate(const void *data, size_t size, v8::Local<v8::Object> chunk);
+
+    /* spectrum analyser, every spectrum is copied into the same Float32Array,
+       handed to JS with "spectrum" */
+    std::unique_ptr<Analyser> analyser;
+    Nan::Global<v8::Float32Array> analyser_output;
+    size_t analyser_accounted;
+    void analyse(const void *data, size_t size);
+    void account_analyser();
+
+    /* native capture to disk, the recorder finishes on its own once stopped */
+    Recorder *recorder;
+    /* stopped, still finishing their file; they must not call back a stream that is gone */
+    std::vector<Recorder*> stopped_recorders;
+    static void RecorderCallback(void *ud, Recorder *recorder, bool finished);
+    void record(Recorder *recorder);
+
+    /* native link from this record stream to a playback stream */
+    Stream *link_target;
+    Nan::Global<v8::Object> link_handle;
+    float link_gain;
+    pa_usec_t link_latency;
+    uint64_t link_dropped;
+    std::vector<float> link_scratch;
+    std::unique_ptr<Remix> link_remix;
+    std::unique_ptr<Drift> link_drift;
+
+    void link(Stream *target, v8::Local<v8::Object> handle, float gain, pa_usec_t latency, double drift_ppm);
+    void link_data(const void *data, size_t size);
+    size_t link_write(const char *src, size_t frames);
     
     /* write */
     pa_usec_t latency; /* latency in micro seconds */
@@ -66,11 +175,98 @@ namespace pulse {
     
     static void RequestCallback(pa_stream *s, size_t len, void *ud);
     size_t request(size_t len);
+    bool write_done();
 
     static void UnderflowCallback(pa_stream *s, void *ud);
     void underflow();
 
+    /* sample rate updates, for variable_rate streams; pa_ss keeps the nominal rate */
+    uint32_t rate_current;
+    uint32_t rate_sent;
+    uint32_t rate_wanted;
+    bool rate_pending;
+    /* setRate() callers, answered once the update carrying their rate (or
+       a later one) lands */
+    std::vector<std::unique_ptr<Pending>> rate_waiting;
+    std::vector<std::unique_ptr<Pending>> rate_sending;
+
+    static void RateCallback(pa_stream *s, int success, void *ud);
+    void update_rate(uint32_t rate);
+
+    /* adaptive target latency, playback only */
+    std::unique_ptr<AdaptiveLatency> adaptive;
+    bool adaptive_pending;
+    pa_usec_t adaptive_applied;
+
+    static void AdaptiveCallback(pa_stream *s, int success, void *ud);
+    void adapt();
+
     void write(v8::Local<v8::Value> buffer, v8::Local<v8::Value> callback);
+    size_t push(const char *src, size_t length, pa_free_cb_t free_cb, void *free_cb_data, bool remixable);
+
+    /* idle auto-cork: a playback stream with nothing (or only silence) to
+       play for a while is corked, so that the sink can suspend, and wakes
+       up on the next write */
+    uv_timer_t *idle_timer;
+    double idle_timeout; /* usec */
+    bool idle_silence;
+    bool idle_corked;
+    bool idle_waking;
+    double idle_last;
+
+    static void IdleCallback(uv_timer_t *timer);
+    void idle(pa_usec_t timeout, bool silence);
+    void wake();
+    void idle_check();
+    void note_audio(const void *data, size_t size);
+
+    /* jitter buffer playback of timestamped packets, instead of writes */
+    std::unique_ptr<JitterBuffer> jitter;
+    size_t jitter_request(size_t length);
+
+    /* native file playback, instead of writes from JS */
+    std::unique_ptr<FileSource> file;
+
+    void play(FileSource *source);
+    size_t file_request(size_t length);
+    void stop();
+
+    /* barge-in: the next write overwrites the queued audio; if it is
+       shorter, the rest of the old audio is silenced and the following
+       write goes back over the silence */
+    bool replace_pending;
+    Nan::Global<v8::Value> replaced_buffer;
+    size_t replaced_offset;
+    size_t replace_rewind;
+
+    void replace();
+    void flush(pa_stream_success_cb_t cb, void *ud);
+    void crossfade(void *data, size_t size);
+    size_t server_queued();
+    void silence_tail(size_t queued, size_t written);
+
+    /* memory accounting, see Context */
+    int64_t memory;
+    int64_t queued;
+    size_t jitter_accounted;
+
+    void account(int64_t native_delta, int64_t queued_delta = 0);
+    void account_jitter();
+
+    /* processing */
+    std::vector<float> scratch;
+    Gain gain;
+    std::unique_ptr<Equalizer> eq;
+
+    bool processing() const;
+    float *float_scratch(size_t samples);
+    void process(void *data, size_t size);
+    void process_float(float *data, size_t frames);
+
+    /* native remixing between the channels written (or delivered to JS)
+       and those of the stream */
+    std::unique_ptr<Remix> remix;
+    v8::Local<v8::Object> remixed(const void *data, size_t size);
     
   public:
     static pa_mainloop_api mainloop_api;
@@ -83,10 +279,53 @@ namespace pulse {
     static void Connect(const Nan::FunctionCallbackInfo<v8::Value>& args);
     static void Disconnect(const Nan::FunctionCallbackInfo<v8::Value>& args);
 
+    static void Monitor(const Nan::FunctionCallbackInfo<v8::Value>& args);
+
+    static void Index(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Device(const Nan::FunctionCallbackInfo<v8::Value>& args);
+
+    static void Events(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Cork(const Nan::FunctionCallbackInfo<v8::Value>& args);
+
     static void Latency(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Time(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Clock(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Timing(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void UpdateTiming(const Nan::FunctionCallbackInfo<v8::Value>& args);
 
     static void Read(const Nan::FunctionCallbackInfo<v8::Value>& args);
     static void Write(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Link(const Nan::FunctionCallbackInfo<v8::Value>& args);
+
+    static void Replace(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Trigger(const Nan::FunctionCallbackInfo<v8::Value>& args);
+
+    static void SetGain(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Memory(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void FormatInfo(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void SetRemix(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void SetEq(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void TruncateEq(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void SetVad(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void SetAnalyser(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void SetAdaptive(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void UpdateRate(const Nan::FunctionCallbackInfo<v8::Value>& args);
+
+    static void SetIdle(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void SetJitter(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Packet(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void JitterStats(const Nan::FunctionCallbackInfo<v8::Value>& args);
+
+    static void Subscribe(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Unsubscribe(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void ResumeSubscriber(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void SubscriberStats(const Nan::FunctionCallbackInfo<v8::Value>& args);
+
+    static void Record(const Nan::FunctionCallbackInfo<v8::Value>& args);
+
+    static void Play(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Seek(const Nan::FunctionCallbackInfo<v8::Value>& args);
+    static void Stop(const Nan::FunctionCallbackInfo<v8::Value>& args);
   };
 }
 
@@ -19,15 +19,54 @@
 
 #include "context.hh"
 
+#include <cstring>
+
 #ifndef DEBUG_UV_MAINLOOP
 #  undef LOG
 #  define LOG(...)
 #endif
 
+/* Event structs are recycled through per-type free lists, as libpulse
+   creates and frees timers all the time on busy streams. A struct only goes
+   back on its list from the close callback of its handle: libuv owns it
+   until then. */
+
+#define EVENT_POOL_MAX 64
+
+template<typename T>
+struct event_pool {
+  T *head;
+  unsigned size;
+
+  T *get(){
+    T *e = head;
+    
+    if(e){
+      head = e->next;
+      size--;
+      memset(e, 0, sizeof(T));
+    }else{
+      e = pa_xnew0(T, 1);
+    }
+    return e;
+  }
+
+  void put(T *e){
+    if(size >= EVENT_POOL_MAX){
+      pa_xfree(e);
+      return;
+    }
+    e->next = head;
+    head = e;
+    size++;
+  }
+};
+
 /* io */
 
 struct pa_io_event {
   uv_poll_t p;
+  pa_io_event *next;
   pa_mainloop_api *a;
   int fd;
   pa_io_event_flags_t ev;
@@ -36,6 +75,13 @@ struct pa_io_event {
   pa_io_event_destroy_cb_t dc;
 };
 
+static thread_local event_pool<pa_io_event> io_pool;
+
+static void
+io_closed(uv_handle_t* h){
+  io_pool.put((pa_io_event*)h->data);
+}
+
 static void
 io_cb(uv_poll_t* p, int st, int ev){
   pa_io_event *e = (pa_io_event*)p->data;
@@ -64,7 +110,9 @@ io_cb(uv_poll_t* p, int st, int ev){
     }
     
     if(pa_ev != PA_IO_EVENT_NULL){
+      PROBE2(io_start, e->fd, pa_ev);
       e->cb(e->a, e, e->fd, pa_ev, e->ud);
+      PROBE1(io_done, e->fd);
     }
   }
 }
@@ -90,7 +138,7 @@ io_new(pa_mainloop_api *a,
   
   m = (uv_loop_t*)a->userdata;
   
-  e = pa_xnew0(pa_io_event, 1);
+  e = io_pool.get();
 
   LOG("io_new(fd=%u,ev=%s%s)->0x%x", fd, ev & PA_IO_EVENT_INPUT ? "in" : "", ev & PA_IO_EVENT_OUTPUT ? "out" : "", e);
   
@@ -116,12 +164,11 @@ io_enable(pa_io_event *e,
   
   LOG("io_enable(0x%x,ev=%s%s)", e, ev & PA_IO_EVENT_INPUT ? "in" : "", ev & PA_IO_EVENT_OUTPUT ? "out" : "");
   
-  if(e->ev != ev){
-    uv_poll_stop(&e->p);
+  /* starting an active poll only updates the events it waits for */
+  if(io_events(e->ev) != io_events(ev)){
     uv_poll_start(&e->p, io_events(ev), io_cb);
-    
-    e->ev = ev;
   }
+  e->ev = ev;
 }
 
 static void
@@ -135,6 +182,8 @@ io_free(pa_io_event *e){
   if(e->dc){
     e->dc(e->a, e, e->ud);
   }
+
+  uv_close((uv_handle_t*)&e->p, io_closed);
 }
 
 static void
@@ -149,6 +198,7 @@ io_set_destroy(pa_io_event *e,
 
 struct pa_time_event {
   uv_timer_t t;
+  pa_time_event *next;
   pa_mainloop_api *a;
   timeval tv;
   pa_time_event_cb_t cb;
@@ -156,12 +206,21 @@ struct pa_time_event {
   pa_time_event_destroy_cb_t dc;
 };
 
+static thread_local event_pool<pa_time_event> time_pool;
+
+static void
+time_closed(uv_handle_t* h){
+  time_pool.put((pa_time_event*)h->data);
+}
+
 static void
 timer_cb(uv_timer_t* t) {
   pa_time_event *e = (pa_time_event*)t->data;
   
   if(e->cb) {
+    PROBE1(timer_start, e);
     e->cb(e->a, e, &e->tv, e->ud);
+    PROBE1(timer_done, e);
   }
 }
 
@@ -170,10 +229,16 @@ timeval_to_millisec(const struct timeval *tv){
   struct timeval ct;
   gettimeofday(&ct, NULL);
   
+  /* a deadline in the past fires on the next loop iteration */
+  if(!timercmp(tv, &ct, >)){
+    return 0;
+  }
+  
   struct timeval dt;
   timersub(tv, &ct, &dt);
   
-  return dt.tv_sec * 1000 + dt.tv_usec / 1000;
+  /* round up, firing early would only get the timer restarted */
+  return dt.tv_sec * 1000 + (dt.tv_usec + 999) / 1000;
 }
 
 static pa_time_event *
@@ -191,20 +256,23 @@ time_new(pa_mainloop_api *a,
   
   m = (uv_loop_t*)a->userdata;
   
-  e = pa_xnew0(pa_time_event, 1);
+  e = time_pool.get();
   
-  LOG("time_new(tv=%d:%d)->0x%x dt=%d", tv->tv_sec, tv->tv_usec, e, timeval_to_millisec(tv));
+  LOG("time_new(tv=%d:%d)->0x%x", tv ? tv->tv_sec : -1, tv ? tv->tv_usec : -1, e);
   
   e->a = a;
   e->cb = cb;
   e->ud = ud;
-  e->tv = *tv;
   
   uv_timer_init(m, &e->t);
   
   e->t.data = e;
   
-  uv_timer_start(&e->t, timer_cb, timeval_to_millisec(tv), 0);
+  /* a NULL time creates a disabled timer */
+  if(tv){
+    e->tv = *tv;
+    uv_timer_start(&e->t, timer_cb, timeval_to_millisec(tv), 0);
+  }
   
   return e;
 }
@@ -214,8 +282,15 @@ time_restart(pa_time_event *e,
              const struct timeval *tv){
   assert(e);
   
-  LOG("time_restart(0x%x,tv=%d:%d) dt=%d", e, tv->tv_sec, tv->tv_usec, timeval_to_millisec(tv));
+  LOG("time_restart(0x%x,tv=%d:%d)", e, tv ? tv->tv_sec : -1, tv ? tv->tv_usec : -1);
   
+  /* a NULL time disables the timer */
+  if(!tv){
+    uv_timer_stop(&e->t);
+    return;
+  }
+  
+  e->tv = *tv;
   uv_timer_start(&e->t, timer_cb, timeval_to_millisec(tv), 0);
 }
 
@@ -230,6 +305,8 @@ time_free(pa_time_event *e){
   if(e->dc){
     e->dc(e->a, e, e->ud);
   }
+
+  uv_close((uv_handle_t*)&e->t, time_closed);
 }
 
 static void
@@ -244,6 +321,7 @@ time_set_destroy(pa_time_event *e,
 
 struct pa_defer_event {
   uv_idle_t i;
+  pa_defer_event *next;
   pa_mainloop_api *a;
   bool en;
   pa_defer_event_cb_t cb;
@@ -251,12 +329,21 @@ struct pa_defer_event {
   pa_defer_event_destroy_cb_t dc;
 };
 
+static thread_local event_pool<pa_defer_event> defer_pool;
+
+static void
+defer_closed(uv_handle_t* h){
+  defer_pool.put((pa_defer_event*)h->data);
+}
+
 static void
 defer_cb(uv_idle_t* i){
   pa_defer_event *e = (pa_defer_event*)i->data;
   
   if(e->cb){
+    PROBE1(defer_start, e);
     e->cb(e->a, e, e->ud);
+    PROBE1(defer_done, e);
   }
 }
 
@@ -274,7 +361,7 @@ defer_new(pa_mainloop_api *a,
   
   m = (uv_loop_t*)a->userdata;
   
-  e = pa_xnew0(pa_defer_event, 1);
+  e = defer_pool.get();
   
   LOG("defer_new()->0x%x", e);
   
@@ -320,6 +407,8 @@ defer_free(pa_defer_event *e){
   if(e->dc){
     e->dc(e->a, e, e->ud);
   }
+
+  uv_close((uv_handle_t*)&e->i, defer_closed);
 }
 
 static void
@@ -0,0 +1,119 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#include "vad.hh"
+#include "sample.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pulse {
+  static const pa_usec_t window_usec = 10000;
+
+  Vad::Vad(const pa_sample_spec& ss_, float threshold_, float margin_, float zcr_max_, pa_usec_t hangover_, pa_usec_t preroll_) :
+    ss(ss_), threshold(threshold_), margin(margin_), zcr_max(zcr_max_),
+    noise(threshold_ - margin_), active(false), silent(0),
+    energy(0), crossings(0), frames(0), last(0),
+    preroll_fill(0), preroll_pos(0) {
+    window = std::max<size_t>(1, pa_usec_to_bytes(window_usec, &ss) / pa_frame_size(&ss));
+    hangover = std::max<size_t>(1, size_t(hangover_ / window_usec));
+
+    size_t frame_size = pa_frame_size(&ss);
+    preroll.resize(pa_usec_to_bytes(preroll_, &ss) / frame_size * frame_size);
+  }
+
+  void Vad::decide() {
+    float db = 10.0f * std::log10(float(energy / double(frames)) + 1e-10f);
+    float zcr = float(crossings) / float(frames);
+
+    bool voiced = db > threshold && db > noise + margin && zcr < zcr_max;
+
+    if (voiced) {
+      active = true;
+      silent = 0;
+    } else {
+      /* follow the noise floor down quickly and up slowly */
+      noise = db < noise ? db : noise + 0.01f * (db - noise);
+      if (active && ++silent >= hangover)
+        active = false;
+    }
+
+    energy = 0;
+    crossings = 0;
+    frames = 0;
+  }
+
+  void Vad::analyse(const void *data, size_t size) {
+    size_t n = size / pa_frame_size(&ss);
+    size_t samples = n * ss.channels;
+
+    if (scratch.size() < samples)
+      scratch.resize(samples);
+    samples_to_float(ss.format, data, scratch.data(), samples);
+
+    const float *s = scratch.data();
+    const float scale = 1.0f / float(ss.channels);
+    for (size_t f = 0; f < n; f++, s += ss.channels) {
+      float v = 0.0f;
+      for (unsigned c = 0; c < ss.channels; c++)
+        v += s[c];
+      v *= scale;
+
+      energy += double(v) * double(v);
+      crossings += (v >= 0.0f) != (last >= 0.0f);
+      last = v;
+
+      if (++frames == window)
+        decide();
+    }
+  }
+
+  void Vad::remember(const void *data, size_t size) {
+    const char *src = static_cast<const char*>(data);
+    size_t cap = preroll.size();
+    if (!cap)
+      return;
+
+    if (size >= cap) {
+      memcpy(preroll.data(), src + size - cap, cap);
+      preroll_pos = 0;
+      preroll_fill = cap;
+      return;
+    }
+
+    size_t first = std::min(size, cap - preroll_pos);
+    memcpy(preroll.data() + preroll_pos, src, first);
+    memcpy(preroll.data(), src + first, size - first);
+    preroll_pos = (preroll_pos + size) % cap;
+    preroll_fill = std::min(cap, preroll_fill + size);
+  }
+
+  size_t Vad::recall(char *dst) {
+    size_t cap = preroll.size();
+    size_t start = (preroll_pos + cap - preroll_fill) % (cap ? cap : 1);
+    size_t first = std::min(preroll_fill, cap - start);
+
+    memcpy(dst, preroll.data() + start, first);
+    memcpy(dst + first, preroll.data(), preroll_fill - first);
+
+    size_t n = preroll_fill;
+    preroll_fill = 0;
+    preroll_pos = 0;
+    return n;
+  }
+}
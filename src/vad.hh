@@ -0,0 +1,76 @@
+//
+// This file is part of node-pulseaudio
+//
+// Copyright © 2026 The Board of Trustees of the Leland Stanford Junior University
+//
+// This library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this library. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __VAD_HH__
+#define __VAD_HH__
+
+#include "common.hh"
+
+namespace pulse {
+  /* Energy and zero-crossing voice activity detector. The signal is cut
+     into short analysis windows; a window is voiced when its energy is
+     above both the absolute threshold and the tracked noise floor plus a
+     margin, and its zero-crossing rate is low enough. Speech ends once no
+     window has been voiced for the hangover time. */
+  class Vad {
+  private:
+    pa_sample_spec ss;
+
+    float threshold;   /* dBFS */
+    float margin;      /* dB above the noise floor */
+    float zcr_max;     /* zero crossings per sample */
+    size_t window;     /* frames per analysis window */
+    size_t hangover;   /* windows */
+
+    float noise;       /* noise floor estimate, dBFS */
+    bool active;
+    size_t silent;     /* windows since the last voiced one */
+
+    /* current window */
+    double energy;
+    size_t crossings;
+    size_t frames;
+    float last;
+
+    std::vector<float> scratch;
+
+    /* pre-roll, a ring of the most recent raw bytes */
+    std::vector<char> preroll;
+    size_t preroll_fill;
+    size_t preroll_pos;
+
+    void decide();
+
+  public:
+    Vad(const pa_sample_spec& ss, float threshold, float margin, float zcr_max, pa_usec_t hangover, pa_usec_t preroll);
+
+    bool speaking() const {
+      return active;
+    }
+
+    void analyse(const void *data, size_t size);
+
+    void remember(const void *data, size_t size);
+    size_t recall(char *dst);
+    size_t remembered() const {
+      return preroll_fill;
+    }
+  };
+}
+
+#endif//__VAD_HH__
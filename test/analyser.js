@@ -0,0 +1,52 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone } = require('./helpers');
+
+const RATE = 16000;
+const SIZE = 1024;
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const opts = {
+        channels: 1,
+        rate: RATE,
+        format: 's16le'
+    };
+
+    const play = ctx.createPlaybackStream(Object.assign({ stream: 'analyser-test' }, opts));
+    play.write(tone(1000, RATE, 3));
+    await new Promise((resolve) => play.once('connection', resolve));
+
+    const input = (await ctx.sinkInputs()).find((i) => i.name === 'analyser-test');
+    const rec = ctx.createRecordStream(Object.assign({ monitor: input.index }, opts));
+    rec.stop();
+
+    const spectrum = await rec.analyse({ size: SIZE, rate: 20 });
+    let count = 0;
+    let peak = 0;
+    rec.on('spectrum', () => {
+        count++;
+        peak = 0;
+        for (let k = 1; k < spectrum.length; k++) {
+            if (spectrum[k] > spectrum[peak])
+                peak = k;
+        }
+    });
+
+    await new Promise((resolve) => setTimeout(resolve, 2000));
+    console.log('spectra', count, 'peak at', peak * RATE / SIZE, 'Hz');
+    if (Math.abs(peak * RATE / SIZE - 1000) > RATE / SIZE)
+        throw new Error('peak is not at 1000Hz');
+
+    await rec.analyse(null);
+    rec.end();
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
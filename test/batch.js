@@ -0,0 +1,48 @@
+"use strict";
+
+const Pulse = require('..');
+
+function countNullSinks(list) {
+    return list.filter((m) => m.name === 'module-null-sink').length;
+}
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const before = countNullSinks(await ctx.modules());
+
+    console.log('batch');
+    const results = await ctx.batch([
+        { op: 'loadModule', name: 'module-null-sink', args: 'sink_name=batch_test' },
+        { op: 'setSinkVolume', sink: 'batch_test', volume: [32768, 32768] },
+        { op: 'setSinkMute', sink: 'batch_test', mute: true }
+    ]);
+    console.log('results', results);
+    if (countNullSinks(await ctx.modules()) !== before + 1)
+        throw new Error('batch did not load the module');
+    await ctx.unloadModule(results[0].index);
+
+    console.log('batch with rollback');
+    try {
+        await ctx.batch([
+            { op: 'loadModule', name: 'module-null-sink', args: 'sink_name=batch_test' },
+            { op: 'unloadModule', index: 0xfffffff0 }
+        ], { rollback: true });
+        throw new Error('batch did not fail');
+    } catch(e) {
+        if (!e.results)
+            throw e;
+        console.log('failed as expected', e.message, e.results);
+        if (!e.results[0].rolledBack)
+            throw new Error('batch was not rolled back');
+    }
+    if (countNullSinks(await ctx.modules()) !== before)
+        throw new Error('rolled back module is still loaded');
+
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
@@ -0,0 +1,68 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone } = require('./helpers');
+
+const RATE = 16000;
+const BUDGET = 64 * 1024;
+
+async function main() {
+    const opts = {
+        channels: 1,
+        rate: RATE,
+        format: 's16le'
+    };
+
+    // drop: writes past the budget are counted and skipped
+    const ctx = new Pulse({
+        client: 'test-client',
+        memoryBudget: BUDGET,
+    });
+    const play = ctx.createPlaybackStream(opts);
+    let dropped = 0;
+    play.on('dropped', (size) => {
+        dropped += size;
+    });
+    // 10 seconds queued before the stream connects
+    for (let i = 0; i < 10; i++)
+        play.write(tone(440, RATE, 1, i * RATE));
+    play.end(tone(440, RATE, 1, 10 * RATE));
+
+    const usage = ctx.memoryUsage();
+    console.log('memory usage', usage, 'dropped', dropped);
+    if (usage.budget !== BUDGET)
+        throw new Error('budget not set');
+    if (usage.native + usage.queued > BUDGET)
+        throw new Error('queued past the budget');
+    if (!dropped || dropped !== play.droppedBytes)
+        throw new Error('nothing dropped');
+
+    await new Promise((resolve) => play.once('finish', resolve));
+    const after = play.memoryUsage();
+    console.log('after finish', after);
+    if (after.queued !== 0)
+        throw new Error('audio still queued after finish');
+    ctx.end();
+
+    // error: the stream fails instead
+    const strict = new Pulse({
+        client: 'test-client',
+        memoryBudget: BUDGET,
+        overBudget: 'error',
+    });
+    const failing = strict.createPlaybackStream(opts);
+    const err = await new Promise((resolve) => {
+        failing.once('error', resolve);
+        for (let i = 0; i < 10 && !failing.destroyed; i++)
+            failing.write(tone(440, RATE, 1, i * RATE));
+    });
+    console.log('over budget:', err.message);
+    if (err.code !== 'E_MEMORY_BUDGET')
+        throw new Error('stream failed with the wrong error');
+    if (strict.memoryUsage().queued !== 0)
+        throw new Error('failed stream still counted');
+    strict.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
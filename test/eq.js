@@ -0,0 +1,67 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone, monitor, levels } = require('./helpers');
+
+const RATE = 16000;
+
+function sleep(ms) {
+    return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+// Level of the 200 Hz tone captured over `ms`, past the first 100 ms.
+async function capture(rec, ms) {
+    const chunks = [];
+    const onData = (chunk) => chunks.push(chunk);
+    rec.on('data', onData);
+    await sleep(ms);
+    rec.removeListener('data', onData);
+    const level = levels(Buffer.concat(chunks), RATE, 10).slice(10).sort((a, b) => a - b);
+    return level[level.length >> 1];
+}
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const opts = {
+        channels: 1,
+        rate: RATE,
+        format: 's16le'
+    };
+
+    const play = ctx.createPlaybackStream(Object.assign({ stream: 'eq-test' }, opts));
+    play.write(tone(200, RATE, 6));
+    await new Promise((resolve) => play.once('connection', resolve));
+
+    // filter what a monitor captures, and compare with the plain tone
+    const rec = await monitor(ctx, 'eq-test', opts);
+    const plain = await capture(rec, 1000);
+
+    rec.setEq([{ type: 'highpass', frequency: 2000 }]);
+    const highpass = await capture(rec, 1000);
+
+    // updating a band keeps the chain
+    rec.setEq([{ type: 'peaking', frequency: 200, q: 1, gain: 0 }]);
+    rec.setEqBand(0, { type: 'peaking', frequency: 200, q: 1, gain: 6 });
+    const peaking = await capture(rec, 1000);
+
+    rec.setEq([]);
+    const removed = await capture(rec, 1000);
+
+    console.log('plain', plain, 'highpass', highpass, 'peaking', peaking, 'removed', removed);
+    if (!(highpass < plain / 10))
+        throw new Error('the high-pass filter does not cut 200Hz');
+    if (!(peaking > plain * 1.8 && peaking < plain * 2.2))
+        throw new Error('the peaking band does not boost 200Hz by 6dB');
+    if (!(Math.abs(removed - plain) < plain / 20))
+        throw new Error('the tone is still filtered once the EQ is removed');
+
+    rec.end();
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
@@ -0,0 +1,31 @@
+"use strict";
+
+const Pulse = require('..');
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    // every sink takes PCM, whatever it plays natively
+    const play = ctx.createPlaybackStream({
+        formats: [{ encoding: 'pcm', format: 's16le', rate: 16000, channels: 1 }]
+    });
+    await new Promise((resolve) => play.once('connection', resolve));
+
+    const info = play.formatInfo();
+    console.log(info);
+    if (info.encoding !== 'pcm')
+        throw new Error(`negotiated ${info.encoding} instead of pcm`);
+    if (info.rate !== 16000 || info.channels !== 1)
+        throw new Error(`negotiated ${info.description}`);
+
+    // and the stream plays at the negotiated rate
+    await new Promise((resolve) => play.write(Buffer.alloc(16000 * 2), resolve));
+
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
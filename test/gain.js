@@ -0,0 +1,66 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone, monitor, levels } = require('./helpers');
+
+const RATE = 16000;
+
+function sleep(ms) {
+    return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const opts = {
+        channels: 1,
+        rate: RATE,
+        format: 's16le'
+    };
+
+    const play = ctx.createPlaybackStream(Object.assign({ stream: 'gain-test' }, opts));
+    await new Promise((resolve) => play.once('connection', resolve));
+
+    // more than one mempool block (64 KiB), processed in several pieces
+    play.setGain(0.5);
+    const buffer = tone(440, RATE, 5);
+    await new Promise((resolve) => play.write(buffer, resolve));
+    await play.updateTiming();
+    const written = play.timing().write_index;
+    console.log('wrote', written, 'of', buffer.length, 'bytes with a gain');
+    if (written !== buffer.length)
+        throw new Error('audio lost on a long write with a gain');
+
+    // a one second linear ramp down on the captured audio: from 3/4 to 1/4
+    // of the level takes half a second, and it ends muted
+    play.write(tone(440, RATE, 4));
+    const rec = await monitor(ctx, 'gain-test', opts);
+    const chunks = [];
+    rec.on('data', (chunk) => chunks.push(chunk));
+    await sleep(1000);
+    rec.setGain(0, { duration: RATE, curve: 'linear' });
+    await sleep(1500);
+    rec.end();
+
+    const level = levels(Buffer.concat(chunks), RATE, 10);
+    const steady = Math.max(...level.slice(0, 80));
+    let i = level.findIndex((l) => l > 0.9 * steady);
+    while (i < level.length && level[i] >= 0.75 * steady)
+        i++;
+    const from = i;
+    while (i < level.length && level[i] >= 0.25 * steady)
+        i++;
+    console.log('ramp from 3/4 to 1/4 in', (i - from) * 10, 'ms');
+    if (i - from < 40 || i - from > 60)
+        throw new Error('the gain ramp is not linear over its duration');
+    if (level[level.length - 1] > 0.01 * steady)
+        throw new Error('the gain ramp did not end muted');
+
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
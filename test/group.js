@@ -0,0 +1,35 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone } = require('./helpers');
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const opts = {
+        channels: 1,
+        rate: 16000,
+        format: 's16le',
+        latency: 100000
+    };
+    const group = ctx.createPlaybackGroup([opts, opts]);
+
+    group.on('start', (time) => {
+        console.log('group started at', time);
+    });
+
+    group.streams[0].write(tone(440, 16000, 2));
+    group.streams[1].write(tone(660, 16000, 2));
+
+    await new Promise((resolve) => setTimeout(resolve, 500));
+    await group.start();
+    await new Promise((resolve) => setTimeout(resolve, 2500));
+
+    group.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
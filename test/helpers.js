@@ -0,0 +1,40 @@
+"use strict";
+
+// Shared fixtures, not a test of its own.
+
+// A mono S16LE sine at `freq` Hz, starting at frame `start` (for
+// consecutive packets) so that the phase carries over.
+function tone(freq, rate, seconds, start) {
+    start = start || 0;
+    const frames = Math.round(rate * seconds);
+    const buffer = Buffer.alloc(frames * 2);
+    for (let i = 0; i < frames; i++)
+        buffer.writeInt16LE(Math.round(8000 * Math.sin(2 * Math.PI * freq * (start + i) / rate)), i * 2);
+    return buffer;
+}
+
+// A record stream of what the playback stream named `name` plays, in short
+// fragments so that what is captured follows playback closely.
+async function monitor(ctx, name, opts) {
+    const input = (await ctx.sinkInputs()).find((i) => i.name === name);
+    return ctx.createRecordStream(Object.assign({ monitor: input.index, latency: 20000 }, opts));
+}
+
+// RMS of each `ms` window of mono S16LE samples.
+function levels(buffer, rate, ms) {
+    const size = Math.round(rate * ms / 1000);
+    const result = [];
+    for (let i = 0; i + size <= buffer.length / 2; i += size) {
+        let sum = 0;
+        for (let j = i; j < i + size; j++)
+            sum += buffer.readInt16LE(j * 2) ** 2;
+        result.push(Math.sqrt(sum / size));
+    }
+    return result;
+}
+
+module.exports = {
+    tone,
+    monitor,
+    levels
+};
@@ -0,0 +1,53 @@
+"use strict";
+
+const Pulse = require('..');
+const path = require('path');
+
+function once(emitter, name, ms) {
+    return new Promise((resolve, reject) => {
+        const timer = setTimeout(() => reject(new Error(`no ${name} after ${ms} ms`)), ms);
+        emitter.once(name, () => {
+            clearTimeout(timer);
+            resolve();
+        });
+    });
+}
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    // test/data/one.wav is mono S16LE at 44.1kHz
+    const play = ctx.createPlaybackStream({
+        channels: 1,
+        rate: 44100,
+        format: 's16le'
+    });
+    await play.idleCork({ timeout: 500000 });
+
+    let active = 0;
+    play.on('active', () => active++);
+
+    await once(play, 'idle', 3000);
+    console.log('idle');
+
+    // a file wakes the stream up, and it goes idle again once played
+    const duration = await play.playFile(path.resolve(__dirname, './data/one.wav'));
+    if (active !== 1)
+        throw new Error('playing a file did not wake the stream up');
+    await once(play, 'played', duration * 1000 + 2000);
+    await once(play, 'idle', 3000);
+    console.log('idle again after the file');
+
+    // and the next write wakes it up once
+    await new Promise((resolve) => play.write(Buffer.alloc(44100 * 2, 1), resolve));
+    if (active !== 2)
+        throw new Error(`${active - 1} wake ups for one write`);
+
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
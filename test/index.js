@@ -11,7 +11,25 @@ async function seq(array) {
 
 seq([
 ('./echo'),
+('./loopback'),
+('./subscribe'),
 ('./info'),
 ('./volume'),
-('./module')
+('./module'),
+('./batch'),
+('./replace'),
+('./group'),
+('./pool'),
+('./monitor'),
+('./jitter'),
+('./analyser'),
+('./remix'),
+('./budget'),
+('./gain'),
+('./idle'),
+('./timing'),
+('./vad'),
+('./eq'),
+('./formats'),
+('./move')
 ]);
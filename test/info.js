@@ -18,6 +18,9 @@ async function main() {
     list = await ctx.sink();
     console.log('sink:', list);
 
+    list = await ctx.sinkInputs();
+    console.log('sink inputs:', list);
+
     ctx.end();
 }
 module.exports = main;
@@ -0,0 +1,45 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone } = require('./helpers');
+
+const RATE = 48000;
+const PACKET = 960; // 20ms
+
+async function main() {
+    const ctx = new Pulse();
+
+    ctx.on('state', (state) => {
+        console.log('context:', state);
+    });
+
+    const play = ctx.createPlaybackStream({
+        channels: 1,
+        rate: RATE,
+        format: 'S16LE',
+        latency: 100000 // in us
+    });
+    await play.jitterBuffer({ min: 20000, max: 200000 });
+
+    // 5s of packets, sent every 20ms with up to 40ms of jitter, some
+    // reordered and 2% lost
+    let ts = 0xffff0000; // wraps around during the test
+    const start = Date.now();
+    for (let i = 0; i < 250; i++, ts = (ts + PACKET) >>> 0) {
+        if (Math.random() < 0.02)
+            continue;
+        const packet = [ts, tone(440, RATE, PACKET / RATE, i * PACKET)];
+        const delay = i * 20 + Math.random() * 40;
+        setTimeout(() => play.pushPacket(...packet), Math.max(0, start + delay - Date.now()));
+    }
+
+    const timer = setInterval(() => console.log(play.jitterStats()), 1000);
+    await new Promise((resolve) => setTimeout(resolve, 5500));
+    clearInterval(timer);
+    console.log(play.jitterStats());
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
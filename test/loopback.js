@@ -0,0 +1,66 @@
+"use strict";
+
+const Pulse = require('..');
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    ctx.on('state', (state) => {
+        console.log('context:', state);
+    });
+
+    const rec = ctx.createRecordStream({
+        channels:1,
+        rate:16000,
+        format:'s16le',
+        flags:'adjust_latency',
+        latency:10000
+    });
+    const play = ctx.createPlaybackStream({
+        channels:2,
+        rate:16000,
+        format:'f32le',
+        flags:'adjust_latency',
+        latency:10000
+    });
+
+    rec.on('state', (state) => {
+        console.log('record:', state);
+    });
+    play.on('state', (state) => {
+        console.log('playback:', state);
+    });
+
+    await rec.link(play, { gain: 0.5, latency: 30000 });
+    rec.stop();
+
+    await new Promise((resolve) => { setTimeout(resolve, 5000); });
+
+    rec.unlink();
+
+    // the same, with drift compensation on the playback rate
+    const vplay = ctx.createPlaybackStream({
+        channels:1,
+        rate:16000,
+        format:'s16le',
+        flags:'variable_rate+auto_timing_update+interpolate_timing',
+        latency:40000
+    });
+    vplay.on('rate', (rate) => {
+        console.log('playback rate:', rate);
+    });
+    await rec.link(vplay, { latency: 40000, drift: true });
+
+    await new Promise((resolve) => { setTimeout(resolve, 5000); });
+
+    rec.unlink();
+    rec.end();
+    play.end();
+    vplay.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
@@ -0,0 +1,39 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone } = require('./helpers');
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const opts = {
+        channels: 1,
+        rate: 16000,
+        format: 's16le'
+    };
+
+    const play = ctx.createPlaybackStream(Object.assign({ stream: 'monitor-test' }, opts));
+    play.write(tone(440, 16000, 3));
+    await new Promise((resolve) => play.once('connection', resolve));
+
+    const input = (await ctx.sinkInputs()).find((i) => i.name === 'monitor-test');
+    console.log('monitoring:', input);
+
+    const rec = ctx.createRecordStream(Object.assign({ monitor: input.index }, opts));
+    let bytes = 0;
+    rec.on('data', (chunk) => {
+        bytes += chunk.length;
+    });
+
+    await new Promise((resolve) => setTimeout(resolve, 2000));
+    console.log('captured', bytes, 'bytes from the sink input');
+
+    rec.end();
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
@@ -0,0 +1,55 @@
+"use strict";
+
+const Pulse = require('..');
+
+function moved(stream, ms) {
+    return new Promise((resolve, reject) => {
+        const timer = setTimeout(() => reject(new Error(`not moved after ${ms} ms`)), ms);
+        stream.once('moved', (name) => {
+            clearTimeout(timer);
+            resolve(name);
+        });
+    });
+}
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    // a sink of our own to move to
+    const nullSink = await ctx.loadModule('module-null-sink', 'sink_name=move-test');
+
+    const play = ctx.createPlaybackStream({
+        channels: 1,
+        rate: 44100,
+        format: 's16le'
+    });
+    await new Promise((resolve) => play.once('connection', resolve));
+    play.write(Buffer.alloc(44100 * 2 * 4));
+
+    const input = (await ctx.sinkInputs()).find((i) => i.index === play.index());
+    if (!input)
+        throw new Error(`no sink input ${play.index()}`);
+    const home = play.device();
+    console.log('playing on', home.name);
+
+    // moved by the stream itself, by name
+    const away = moved(play, 2000);
+    await play.moveTo('move-test');
+    if (await away !== 'move-test' || play.device().name !== 'move-test')
+        throw new Error(`moved to ${play.device().name} instead of move-test`);
+
+    // and back by the context, by index
+    const back = moved(play, 2000);
+    await ctx.moveSinkInput(play.index(), home.index);
+    if (await back !== home.name || play.device().index !== home.index)
+        throw new Error(`moved to ${play.device().name} instead of ${home.name}`);
+
+    play.end();
+    await ctx.unloadModule(nullSink);
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
@@ -0,0 +1,40 @@
+"use strict";
+
+const Pulse = require('..');
+const wav = require('wav');
+const fs = require('fs');
+
+async function main() {
+    const ctx = new Pulse();
+
+    ctx.on('state', (state) => {
+        console.log('context:', state);
+    });
+
+    // only read the header, the audio is played natively
+    const reader = new wav.Reader();
+    fs.createReadStream(process.argv[2]).pipe(reader);
+
+    reader.on('format', async (fmt) => {
+        console.log(fmt);
+        reader.unpipe();
+
+        const play = ctx.createPlaybackStream({
+            channels: fmt.channels,
+            rate: fmt.sampleRate,
+            format: (fmt.signed ? 'S' : 'U') + fmt.bitDepth + fmt.endianness,
+            latency: 500000 // in us
+        });
+
+        const duration = await play.playFile(process.argv[2]);
+        console.log('duration:', duration);
+
+        play.on('played', () => {
+            setTimeout(() => {
+                play.end();
+                ctx.end();
+            }, 1000);
+        });
+    });
+}
+main();
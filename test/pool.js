@@ -0,0 +1,31 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone } = require('./helpers');
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const opts = {
+        channels: 1,
+        rate: 16000,
+        format: 's16le',
+        latency: 100000
+    };
+    ctx.preparePlaybackStreams(opts, 2);
+    await new Promise((resolve) => setTimeout(resolve, 1000));
+
+    const start = Date.now();
+    const stream = ctx.createPlaybackStream(opts);
+    console.log('acquired stream in', Date.now() - start, 'ms, connected:', stream._connected);
+    stream.write(tone(440, 16000, 1));
+    stream.end();
+    await new Promise((resolve) => stream.once('finish', resolve));
+
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
@@ -0,0 +1,30 @@
+"use strict";
+
+const Pulse = require('..');
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const rec = ctx.createRecordStream({
+        channels: 1,
+        rate: 16000,
+        format: 's16le',
+        latency: 10000
+    });
+
+    await rec.recordFile('./out.wav', { sync: 'periodic', flush: 500000 });
+    rec.stop();
+    rec.on('recording', (frames, dropped) => {
+        console.log('recording:', frames, 'frames,', dropped, 'dropped');
+    });
+
+    process.on('SIGINT', async () => {
+        console.log('recorded:', await rec.stopRecording());
+        rec.end();
+        ctx.end();
+    });
+}
+
+main();
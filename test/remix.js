@@ -0,0 +1,56 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone } = require('./helpers');
+
+const RATE = 16000;
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const play = ctx.createPlaybackStream({
+        stream: 'remix-test',
+        channelMap: 'stereo',
+        rate: RATE,
+        format: 's16le',
+        flags: 'no_remix_channels'
+    });
+    await play.setRemix(1, [[1], [0]]); // mono writes go to the left channel only
+    const mono = tone(440, RATE, 3);
+    play.write(mono);
+
+    const input = (await ctx.sinkInputs()).find((i) => i.name === 'remix-test');
+    const rec = ctx.createRecordStream({
+        monitor: input.index,
+        latency: 20000, // in usec, to capture while it plays
+        channelMap: 'stereo',
+        rate: RATE,
+        format: 's16le'
+    });
+    const energy = [0, 0];
+    rec.on('data', (chunk) => {
+        for (let i = 0; i + 4 <= chunk.length; i += 4) {
+            energy[0] += chunk.readInt16LE(i) ** 2;
+            energy[1] += chunk.readInt16LE(i + 2) ** 2;
+        }
+    });
+
+    await new Promise((resolve) => setTimeout(resolve, 2000));
+    console.log('left energy', energy[0], 'right energy', energy[1]);
+    if (energy[0] === 0 || energy[1] * 100 > energy[0])
+        throw new Error('mono writes were not remixed to the left channel');
+
+    // the stereo frames take more than one mempool block, none may be lost
+    await play.updateTiming();
+    if (play.timing().write_index !== 2 * mono.length)
+        throw new Error('remixed audio lost on a long write');
+
+    rec.end();
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
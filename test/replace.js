@@ -0,0 +1,107 @@
+"use strict";
+
+const Pulse = require('..');
+const wav = require('wav');
+const fs = require('fs');
+const path = require('path');
+const { tone } = require('./helpers');
+
+function readWav(file) {
+    return new Promise((resolve, reject) => {
+        const reader = new wav.Reader();
+        const chunks = [];
+        let format;
+        reader.on('format', (fmt) => {
+            format = fmt;
+        });
+        reader.on('data', (data) => chunks.push(data));
+        reader.on('end', () => resolve([format, Buffer.concat(chunks)]));
+        reader.on('error', reject);
+        fs.createReadStream(file).pipe(reader);
+    });
+}
+
+function sleep(ms) {
+    return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+// Longest run of 10 ms windows louder than `threshold` (RMS), in seconds.
+function longestSound(samples, rate, threshold) {
+    const size = Math.round(rate / 100);
+    let run = 0;
+    let longest = 0;
+    for (let i = 0; i + size <= samples.length / 2; i += size) {
+        let sum = 0;
+        for (let j = i; j < i + size; j++)
+            sum += samples.readInt16LE(j * 2) ** 2;
+        run = Math.sqrt(sum / size) > threshold ? run + 1 : 0;
+        longest = Math.max(longest, run);
+    }
+    return longest / 100;
+}
+
+async function main() {
+    const ctx = new Pulse();
+
+    const [fmt, one] = await readWav(process.argv[2] || path.resolve(__dirname, './data/one.wav'));
+    const [, two] = await readWav(process.argv[3] || path.resolve(__dirname, './data/two.wav'));
+
+    const play = ctx.createPlaybackStream({
+        stream: 'replace-test',
+        latency: 200000, // in usec
+        channels: fmt.channels,
+        rate: fmt.sampleRate,
+        format: (fmt.signed ? 'S' : 'U') + fmt.bitDepth + fmt.endianness,
+    });
+
+    play.write(one);
+    await sleep(300);
+
+    console.log('barge in');
+    play.replace(two);
+    await play.trigger();
+
+    const bytesPerSecond = fmt.bitDepth / 8 * fmt.sampleRate * fmt.channels;
+    const duration = two.length / bytesPerSecond;
+    await sleep(duration * 1000 + 500);
+
+    const input = (await ctx.sinkInputs()).find((i) => i.name === 'replace-test');
+    const rec = ctx.createRecordStream({
+        monitor: input.index,
+        latency: 20000, // in usec, to capture while it plays
+        channels: 1,
+        rate: fmt.sampleRate,
+        format: 's16le'
+    });
+    await new Promise((resolve) => rec.once('connection', resolve));
+    const chunks = [];
+    rec.on('data', (chunk) => chunks.push(chunk));
+
+    // a replacement shorter than what is queued: the rest of `one` must not
+    // be heard after it, and what is written next goes back over the silence
+    // that replaced it, but not over what of it already played
+    play.write(one);
+    await sleep(300);
+
+    console.log('short barge in');
+    const frame = fmt.bitDepth / 8 * fmt.channels;
+    play.replace(two.slice(0, Math.floor(bytesPerSecond * 0.05 / frame) * frame));
+    await play.trigger();
+    await sleep(50);
+
+    console.log('write after the short barge in');
+    play.write(tone(440, fmt.sampleRate, 1));
+    await sleep(2000);
+
+    const heard = longestSound(Buffer.concat(chunks), fmt.sampleRate, 1000);
+    console.log('heard', heard, 's of the 1 s tone');
+    if (heard < 0.98)
+        throw new Error('the write after a short barge in was cut');
+
+    rec.end();
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
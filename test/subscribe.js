@@ -0,0 +1,41 @@
+"use strict";
+
+const Pulse = require('..');
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const rec = ctx.createRecordStream({
+        channels: 1,
+        rate: 16000,
+        format: 's16le',
+        latency: 10000
+    });
+    rec.stop();
+
+    // one consumer keeps up, the other one never reads and overflows
+    const fast = rec.subscribe();
+    const slow = rec.subscribe({ limit: 32000 });
+    slow.pause();
+
+    let bytes = 0;
+    fast.on('data', (chunk) => {
+        bytes += chunk.length;
+    });
+
+    await new Promise((resolve) => setTimeout(resolve, 3000));
+    console.log('fast:', bytes, 'bytes, dropped', fast.dropped);
+    console.log('slow:', slow.readableLength, 'bytes buffered, dropped', slow.dropped);
+    if (!slow.dropped)
+        throw new Error('the slow consumer should have dropped audio');
+
+    fast.destroy();
+    slow.destroy();
+    rec.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
@@ -0,0 +1,76 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone } = require('./helpers');
+
+const RATE = 16000;
+
+function sleep(ms) {
+    return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+// clock() follows real time while the stream plays
+async function checkClock(play, what) {
+    const t0 = play.clock();
+    const start = process.hrtime.bigint();
+    await sleep(500);
+    play.clock();
+    await sleep(200);
+    const elapsed = Number(process.hrtime.bigint() - start) / 1000;
+    const advanced = play.clock() - t0;
+    console.log(what, 'clock advanced', advanced, 'us in', elapsed, 'us');
+    if (Math.abs(advanced - elapsed) > 100000)
+        throw new Error(`clock of the ${what} stream does not follow playback`);
+}
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const opts = {
+        channels: 1,
+        rate: RATE,
+        format: 's16le'
+    };
+
+    const auto = ctx.createPlaybackStream(Object.assign({ flags: 'interpolate_timing+auto_timing_update' }, opts));
+    auto.write(tone(440, RATE, 4));
+    await new Promise((resolve) => auto.once('connection', resolve));
+    await sleep(500);
+
+    const timing = auto.timing();
+    console.log('timing:', timing, 'latency:', auto.latency(), 'time:', auto.time());
+    if (!timing || !timing.playing || timing.write_index <= timing.read_index)
+        throw new Error('no timing info for a playing stream');
+    if (!(auto.latency() > 0) || !(auto.time() > 0))
+        throw new Error('no latency or time for a playing stream');
+
+    await checkClock(auto, 'auto updated');
+
+    // without auto_timing_update, clock() asks for the updates itself
+    const manual = ctx.createPlaybackStream(opts);
+    manual.write(tone(440, RATE, 4));
+    await new Promise((resolve) => manual.once('connection', resolve));
+    await manual.updateTiming();
+    await sleep(500);
+
+    await checkClock(manual, 'manually updated');
+
+    // and never goes back
+    let last = 0;
+    for (let i = 0; i < 50; i++) {
+        const now = manual.clock();
+        if (now < last)
+            throw new Error('clock went back');
+        last = now;
+        await sleep(10);
+    }
+
+    auto.end();
+    manual.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
@@ -0,0 +1,51 @@
+"use strict";
+
+const Pulse = require('..');
+const { tone, monitor } = require('./helpers');
+
+const RATE = 16000;
+
+async function main() {
+    const ctx = new Pulse({
+        client: 'test-client',
+    });
+
+    const opts = {
+        channels: 1,
+        rate: RATE,
+        format: 's16le'
+    };
+
+    const play = ctx.createPlaybackStream(Object.assign({ stream: 'vad-test' }, opts));
+    await new Promise((resolve) => play.once('connection', resolve));
+
+    const rec = await monitor(ctx, 'vad-test', opts);
+    rec.vad({ hangover: 300000, preroll: 200000 });
+    const events = [];
+    let bytes = 0;
+    rec.on('speechstart', () => events.push('speechstart'));
+    rec.on('speechend', () => events.push('speechend'));
+    rec.on('data', (chunk) => {
+        bytes += chunk.length;
+    });
+    await new Promise((resolve) => rec.once('connection', resolve));
+
+    // one second of "speech" between silences
+    play.write(Buffer.concat([Buffer.alloc(RATE * 2), tone(440, RATE, 1), Buffer.alloc(RATE * 2 * 2)]));
+    await new Promise((resolve) => setTimeout(resolve, 4500));
+
+    const seconds = bytes / 2 / RATE;
+    console.log(events, 'delivered', seconds, 's');
+    if (events.join() !== 'speechstart,speechend')
+        throw new Error('speech not detected once');
+    // the tone, with the pre-roll and hangover, give or take a fragment
+    if (seconds < 1.3 || seconds > 1.8)
+        throw new Error('silence delivered, or speech left out');
+
+    rec.end();
+    play.end();
+    ctx.end();
+}
+module.exports = main;
+if (!module.parent)
+    main();
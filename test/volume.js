@@ -21,9 +21,28 @@ async function testSink(ctx, server) {
     await ctx.setSinkVolume(server.default_sink_name, [65536/2, 65536/2]);
     await sleep(5000);
 
+    console.log('set sink volume (burst)');
+    const updates = [];
+    for (let i = 0; i <= 60; i++)
+        updates.push(ctx.setSinkVolume(server.default_sink_name, [65536 * i / 60, 65536 * i / 60].map(Math.round)));
+    await Promise.all(updates);
+    const after = (await ctx.sink()).find((sink) => sink.name === server.default_sink_name);
+    if (after.volume[0] !== 65536)
+        throw new Error('coalesced volume did not land on the last value');
+    await sleep(5000);
+
     console.log('restoring');
     await ctx.setSinkMute(server.default_sink_name, current.mute);
     await ctx.setSinkVolume(server.default_sink_name, current.volume);
+
+    console.log('set missing sink volume (burst)');
+    const failures = [];
+    for (let i = 0; i < 3; i++)
+        failures.push(ctx.setSinkVolume('no-such-sink', [65536, 65536]).then(() => null, (err) => err));
+    for (const err of await Promise.all(failures)) {
+        if (!err)
+            throw new Error('volume update of a missing sink succeeded');
+    }
 }
 
 async function testSource(ctx, server) {